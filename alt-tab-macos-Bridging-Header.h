@@ -1,2 +1,3 @@
 #import "AppCenterApplication.h"
 #import "ObjCExceptionCatcher.h"
+#import "StorageProbe.h"
@@ -67,6 +67,9 @@ class App: AppCenterApplication {
         KeyboardEvents.updateEscapeAbsorptionTap() // session closed: stop tapping keyDown (#5766)
         UsageStats.resetSession()
         TilesView.endSearchSession()
+        AXCallScheduler.shared.boost([])
+        AXCallScheduler.shared.dropSessionWork()
+        WindowThumbnails.markShown([])
         ContextMenuEvents.toggle(false)
         CursorEvents.toggle(false)
         TrackpadEvents.reset()
@@ -301,6 +304,7 @@ class App: AppCenterApplication {
         guard SwitcherSession.isActive else { return }
         TilesPanel.shared.updateContents(preservedScrollOrigin)
         guard SwitcherSession.isActive else { return }
+        Windows.visibleTilesChanged()
         Windows.voiceOverWindow() // at this point TileViews are assigned to the window, and ready
         guard SwitcherSession.isActive else { return }
         WindowThumbnails.previewSelectedIfNeeded()
@@ -419,6 +423,7 @@ class App: AppCenterApplication {
         }
         PreferencesEvents.initialize()
         BenchmarkRunner.startIfNeeded()
+        WsTraceRecorder.startIfNeeded()
         showSettingsWindowOnFirstLaunchIfNeeded()
         if pendingShowSettingsWindow {
             pendingShowSettingsWindow = false
@@ -430,7 +435,7 @@ class App: AppCenterApplication {
         if QAMenu.openSettingsOnLaunch { App.showSettingsWindow() }
         if QAMenu.graphEnabled { DebugMenu.setEnabled(true) }
         #endif
-        UsageStats.prune()
+        UsageStats.compactInBackground()
         ProTransitionManager.shared.onAction = { ProPromptHost.shared.dispatch($0) }
         ProTransitionManager.shared.onAppLaunchComplete()
         Logger.info { "Finished launching AltTab" }
@@ -522,6 +527,8 @@ extension App: NSApplicationDelegate {
     func applicationWillTerminate(_ notification: Notification) {
         // symbolic hotkeys state persist after the app is quit; we restore this shortcut before quitting
         setNativeCommandTabEnabled(true)
+        WsTraceRecorder.stop()
+        Logger.flushNow()
     }
 
     func applicationShouldTerminate(_ sender: NSApplication) -> NSApplication.TerminateReply {
@@ -9,3 +9,20 @@ func XCTAssertArraysEqualUnordered<T: Comparable>(
 ) {
     XCTAssertEqual(array1.sorted(), array2.sorted(), message(), file: file, line: line)
 }
+
+/// Deterministic generator (SplitMix64) so randomized and benchmark inputs are the same on every run
+struct SeededGenerator: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+}
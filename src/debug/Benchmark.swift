@@ -16,9 +16,45 @@ final class BenchmarkRunner {
         case .showUi(let count):
             remainingCycles = count
             scheduleShow(after: startupDelay)
+        case .logger:
+            DispatchQueue.main.asyncAfter(deadline: .now() + .milliseconds(startupDelay)) {
+                benchmarkLogger()
+                App.shared.terminate(nil)
+            }
+        case .appCenterStorage:
+            DispatchQueue.main.asyncAfter(deadline: .now() + .milliseconds(startupDelay)) {
+                StorageBenchmark.run()
+                App.shared.terminate(nil)
+            }
         }
     }
 
+    /// Per-call cost of a suppressed and of an emitted `Logger` call on the main thread. Emitted calls stay
+    /// below the console's level (unless `--logs=debug`), so this times the hot path, not the terminal. The
+    /// rings are flushed between batches, outside the timing, so none fill up.
+    private static func benchmarkLogger() {
+        let previous = Logger.minLevel
+        Logger.minLevel = .info
+        let suppressed = nsPerLoggerCall { i in Logger.debug { "suppressed \(i)" } }
+        Logger.minLevel = .debug
+        let emitted = nsPerLoggerCall { i in Logger.debug { "emitted \(i)" } }
+        Logger.minLevel = previous
+        print("Logger: suppressed \(suppressed) ns/call, emitted \(emitted) ns/call")
+    }
+
+    private static func nsPerLoggerCall(_ call: (Int) -> Void) -> Double {
+        let batches = 100
+        let batchSize = 2048
+        var totalNs: UInt64 = 0
+        for batch in 0..<batches {
+            let start = DispatchTime.now().uptimeNanoseconds
+            for i in 0..<batchSize { call(batch * batchSize + i) }
+            totalNs += DispatchTime.now().uptimeNanoseconds - start
+            Logger.flushNow()
+        }
+        return Double(totalNs) / Double(batches * batchSize)
+    }
+
     private static func scheduleShow(after delay: Int) {
         guard remainingCycles > 0 else { scheduleTerminate(after: hideDuration); return }
         DispatchQueue.main.asyncAfter(deadline: .now() + .milliseconds(delay)) {
@@ -46,6 +82,8 @@ struct BenchmarkConfig {
     enum Mode {
         case launch
         case showUi(Int)
+        case logger
+        case appCenterStorage
     }
 
     let mode: Mode
@@ -55,6 +93,8 @@ struct BenchmarkConfig {
         let mode = args[index + 1]
         if mode == "launch" { return BenchmarkConfig(mode: .launch) }
         if mode == "showUi" { return parseShowUi(args, index) }
+        if mode == "logger" { return BenchmarkConfig(mode: .logger) }
+        if mode == "appCenterStorage" { return BenchmarkConfig(mode: .appCenterStorage) }
         print("Unsupported benchmark mode: \(mode)")
         return nil
     }
@@ -0,0 +1,156 @@
+import Foundation
+import SQLite3
+
+#if DEBUG
+/// `--benchmark appCenterStorage`: inserts/s and batch-load latency of the App Center log store, before and after it
+/// kept its connection open. The after numbers drive the vendored `MSACLogDBStorage` through `StorageProbe`, on a
+/// scratch database. The connection-per-query code they replaced is gone, so the before numbers replay its table,
+/// statements and pragmas with SQLite directly. Both sides archive the same logs on insert and unarchive them on load,
+/// as the storage does. The run ends with the probe's self-checks.
+enum StorageBenchmark {
+    static let logCount = 2000
+    static let payloadLength = 1500
+    static let batchSize = 50
+    static let flushLimit = 50
+    static let flushCount = 200
+
+    private static let transient = unsafeBitCast(-1, to: sqlite3_destructor_type.self)
+    private static let schema = "CREATE TABLE \"logs\" (\"id\" INTEGER PRIMARY KEY AUTOINCREMENT, \"groupId\" TEXT NOT NULL, "
+        + "\"log\" TEXT NOT NULL, \"targetToken\" TEXT, \"targetKey\" TEXT, \"priority\" INTEGER)"
+    private static let insert = "INSERT INTO \"logs\" (\"groupId\", \"log\", \"priority\") VALUES (?, ?, ?)"
+    private static let select = "SELECT * FROM \"logs\" WHERE \"groupId\" = ? ORDER BY \"priority\" DESC, \"id\" ASC LIMIT \(flushLimit + 1)"
+    // App Center's default 10 MiB, in 4 KiB pages
+    private static let maxPageCount = "PRAGMA max_page_count = 2560"
+
+    static func run() {
+        let path = NSTemporaryDirectory() + "alt-tab-storage-benchmark.sqlite"
+        let logs = StorageProbe.logs(withCount: logCount, payloadLength: payloadLength)
+        createDatabase(path)
+        let reopening = insertsPerSecondReopening(path, logs)
+        let reopeningFlush = flushMsReopening(path)
+        removeDatabase(path)
+        let persistent = StorageProbe.insertsPerSecond(withLogCount: logCount, payloadLength: payloadLength, batchSize: 1)
+        let batched = StorageProbe.insertsPerSecond(withLogCount: logCount, payloadLength: payloadLength, batchSize: batchSize)
+        let persistentFlush = StorageProbe.loadMilliseconds(withLogCount: logCount, payloadLength: payloadLength,
+            limit: flushLimit, loadCount: flushCount)
+        let failures = StorageProbe.selfCheckFailures()
+        print("App Center storage (\(logCount) logs, flushes of \(flushLimit)):")
+        print("  connection per query (4.3.0, replayed): \(Int(reopening)) inserts/s, flush \(String(format: "%.3f", reopeningFlush)) ms")
+        print("  MSACLogDBStorage: \(Int(persistent)) inserts/s, \(Int(batched)) inserts/s with saveLogs in batches of \(batchSize), "
+            + "flush \(String(format: "%.3f", persistentFlush)) ms")
+        print("  self-checks: " + (failures.isEmpty ? "passed" : "\(failures.count) failed"))
+        failures.forEach { print("    \($0)") }
+    }
+
+    /// what `enqueueItem:flags:` cost per log: archive, open, set the size limit, read it back, prepare, insert, finalize, close
+    private static func insertsPerSecondReopening(_ path: String, _ logs: [NSObject]) -> Double {
+        let elapsed = seconds {
+            for log in logs {
+                let db = open(path)
+                exec(db, maxPageCount)
+                exec(db, "PRAGMA max_page_count")
+                let statement = prepare(db, insert)
+                insertLog(statement, archive(log))
+                sqlite3_finalize(statement)
+                sqlite3_close(db)
+            }
+        }
+        return Double(logCount) / elapsed
+    }
+
+    /// what loading a batch to send cost: open, prepare, every row copied into arrays of objects, then each log unarchived
+    private static func flushMsReopening(_ path: String) -> Double {
+        let elapsed = seconds {
+            for _ in 0..<flushCount {
+                let db = open(path)
+                exec(db, maxPageCount)
+                let statement = prepare(db, select)
+                sqlite3_bind_text(statement, 1, "group", -1, transient)
+                var rows = [[Any]]()
+                while sqlite3_step(statement) == SQLITE_ROW {
+                    var row = [Any]()
+                    for column in 0..<sqlite3_column_count(statement) {
+                        switch sqlite3_column_type(statement, column) {
+                            case SQLITE_INTEGER: row.append(Int(sqlite3_column_int64(statement, column)))
+                            case SQLITE_TEXT: row.append(String(cString: sqlite3_column_text(statement, column)))
+                            default: row.append(NSNull())
+                        }
+                    }
+                    rows.append(row)
+                }
+                for row in rows {
+                    _ = unarchive(row[2] as! String)
+                }
+                sqlite3_finalize(statement)
+                sqlite3_close(db)
+            }
+        }
+        return elapsed * 1000 / Double(flushCount)
+    }
+
+    /// `MSACUtility.archiveKeyedData`, base64-encoded as `saveLog` stores it
+    private static func archive(_ log: NSObject) -> String {
+        let data = try! NSKeyedArchiver.archivedData(withRootObject: log, requiringSecureCoding: false)
+        return data.base64EncodedString(options: .endLineWithLineFeed)
+    }
+
+    /// `MSACUtility.unarchiveKeyedData` of a stored log
+    private static func unarchive(_ base64: String) -> Any? {
+        guard let data = Data(base64Encoded: base64, options: .ignoreUnknownCharacters),
+              let unarchiver = try? NSKeyedUnarchiver(forReadingFrom: data) else { return nil }
+        unarchiver.requiresSecureCoding = false
+        return try? unarchiver.decodeTopLevelObject(forKey: NSKeyedArchiveRootObjectKey)
+    }
+
+    /// priority 1, the `MSACFlagsNormal` the probe saves with
+    private static func insertLog(_ statement: OpaquePointer, _ log: String) {
+        sqlite3_bind_text(statement, 1, "group", -1, transient)
+        sqlite3_bind_text(statement, 2, log, -1, transient)
+        sqlite3_bind_int64(statement, 3, 1)
+        precondition(sqlite3_step(statement) == SQLITE_DONE)
+    }
+
+    private static func createDatabase(_ path: String) {
+        removeDatabase(path)
+        let db = open(path)
+        exec(db, "PRAGMA auto_vacuum = FULL")
+        exec(db, schema)
+        exec(db, "CREATE INDEX \"ix_logs_priority\" ON \"logs\" (\"priority\")")
+        sqlite3_close(db)
+    }
+
+    private static func removeDatabase(_ path: String) {
+        for suffix in ["", "-wal", "-shm"] {
+            try? FileManager.default.removeItem(atPath: path + suffix)
+        }
+    }
+
+    private static func open(_ path: String) -> OpaquePointer {
+        var db: OpaquePointer?
+        precondition(sqlite3_open_v2(path, &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nil) == SQLITE_OK)
+        return db!
+    }
+
+    private static func exec(_ db: OpaquePointer, _ sql: String) {
+        precondition(sqlite3_exec(db, sql, nil, nil, nil) == SQLITE_OK, String(cString: sqlite3_errmsg(db)))
+    }
+
+    private static func prepare(_ db: OpaquePointer, _ sql: String) -> OpaquePointer {
+        var statement: OpaquePointer?
+        precondition(sqlite3_prepare_v2(db, sql, -1, &statement, nil) == SQLITE_OK, String(cString: sqlite3_errmsg(db)))
+        return statement!
+    }
+
+    private static func seconds(_ body: () -> Void) -> Double {
+        let start = DispatchTime.now().uptimeNanoseconds
+        body()
+        return Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+    }
+}
+#else
+enum StorageBenchmark {
+    static func run() {
+        print("--benchmark appCenterStorage needs a debug build: StorageProbe reaches App Center's internal headers")
+    }
+}
+#endif
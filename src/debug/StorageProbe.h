@@ -0,0 +1,24 @@
+#if DEBUG
+@import Foundation;
+
+/// Drives App Center's internal log storage on scratch databases, for `--benchmark appCenterStorage`. Debug builds
+/// only: it reaches the SDK's private headers, which only `debug.xcconfig` puts on the header search path.
+@interface StorageProbe : NSObject
+
+/// Logs saved per second, one `saveLog:` per log when `batchSize` is 1, else `saveLogs:` per `batchSize` logs.
++ (double)insertsPerSecondWithLogCount:(NSUInteger)logCount payloadLength:(NSUInteger)payloadLength batchSize:(NSUInteger)batchSize;
+
+/// Average milliseconds to load a batch of `limit` logs. Each batch is released before the next, so they all read the same logs.
++ (double)loadMillisecondsWithLogCount:(NSUInteger)logCount
+                         payloadLength:(NSUInteger)payloadLength
+                                 limit:(NSUInteger)limit
+                             loadCount:(NSUInteger)loadCount;
+
+/// Logs like the ones the benchmark saves, for a baseline to archive the same way.
++ (NSArray<NSObject *> *)logsWithCount:(NSUInteger)count payloadLength:(NSUInteger)payloadLength;
+
+/// Exercises the statement cache, batched inserts, the size limit and dropping the database; describes each failed check.
++ (NSArray<NSString *> *)selfCheckFailures;
+
+@end
+#endif
@@ -0,0 +1,206 @@
+#if DEBUG
+#import <sqlite3.h>
+#import "StorageProbe.h"
+#import "MSACConstants+Flags.h"
+#import "MSACDBStoragePrivate.h"
+#import "MSACLogDBStoragePrivate.h"
+#import "MSACLogWithProperties.h"
+#import "MSACStorageBindableArray.h"
+#import "MSACUtility+File.h"
+
+static NSString *const logsFileName = @"StorageProbeLogs.sqlite";
+static NSString *const checksFileName = @"StorageProbe.sqlite";
+static NSString *const tableName = @"probe";
+static NSString *const groupId = @"probe";
+
+/// `MSACLogDBStorage` on a scratch file: its `init` passes `Logs.sqlite`, the database logs are sent from
+@interface StorageProbeLogDBStorage : MSACLogDBStorage
+@end
+
+@implementation StorageProbeLogDBStorage
+
+- (instancetype)initWithSchema:(MSACDBSchema *)schema version:(NSUInteger)version filename:(NSString *)__unused filename {
+    return [super initWithSchema:schema version:version filename:logsFileName];
+}
+
+@end
+
+@implementation StorageProbe
+
++ (double)insertsPerSecondWithLogCount:(NSUInteger)logCount payloadLength:(NSUInteger)payloadLength batchSize:(NSUInteger)batchSize {
+    MSACLogDBStorage *storage = [self emptyLogStorage];
+    NSArray<id<MSACLog>> *logs = (NSArray<id<MSACLog>> *)[self logsWithCount:logCount payloadLength:payloadLength];
+    NSTimeInterval start = NSProcessInfo.processInfo.systemUptime;
+    if (batchSize > 1) {
+        for (NSUInteger i = 0; i < logs.count; i += batchSize) {
+            NSArray<id<MSACLog>> *batch = [logs subarrayWithRange:NSMakeRange(i, MIN(batchSize, logs.count - i))];
+            [storage saveLogs:batch withGroupId:groupId flags:MSACFlagsNormal];
+        }
+    } else {
+        for (id<MSACLog> log in logs) {
+            [storage saveLog:log withGroupId:groupId flags:MSACFlagsNormal];
+        }
+    }
+    NSTimeInterval elapsed = NSProcessInfo.processInfo.systemUptime - start;
+    [storage dropDatabase];
+    return logCount / elapsed;
+}
+
++ (double)loadMillisecondsWithLogCount:(NSUInteger)logCount
+                         payloadLength:(NSUInteger)payloadLength
+                                 limit:(NSUInteger)limit
+                             loadCount:(NSUInteger)loadCount {
+    MSACLogDBStorage *storage = [self emptyLogStorage];
+    [storage saveLogs:(NSArray<id<MSACLog>> *)[self logsWithCount:logCount payloadLength:payloadLength] withGroupId:groupId flags:MSACFlagsNormal];
+    NSTimeInterval start = NSProcessInfo.processInfo.systemUptime;
+    for (NSUInteger i = 0; i < loadCount; i++) {
+        [storage loadLogsWithGroupId:groupId limit:limit excludedTargetKeys:nil completionHandler:nil];
+        // as if the batch failed to send: its logs are available again
+        [storage.batches removeAllObjects];
+    }
+    NSTimeInterval elapsed = NSProcessInfo.processInfo.systemUptime - start;
+    [storage dropDatabase];
+    return elapsed * 1000 / loadCount;
+}
+
++ (NSArray<NSObject *> *)logsWithCount:(NSUInteger)count payloadLength:(NSUInteger)payloadLength {
+    NSString *payload = [@"" stringByPaddingToLength:payloadLength withString:@"*" startingAtIndex:0];
+    NSMutableArray<NSObject *> *logs = [NSMutableArray new];
+    for (NSUInteger i = 0; i < count; i++) {
+        MSACLogWithProperties *log = [MSACLogWithProperties new];
+        log.type = @"probe";
+        log.timestamp = [NSDate date];
+        log.properties = @{@"payload": payload};
+        [logs addObject:log];
+    }
+    return logs;
+}
+
++ (MSACLogDBStorage *)emptyLogStorage {
+    [self removeDatabaseNamed:logsFileName];
+    return [StorageProbeLogDBStorage new];
+}
+
++ (void)removeDatabaseNamed:(NSString *)fileName {
+    for (NSString *suffix in @[@"", @"-wal", @"-shm"]) {
+        NSString *pathComponent = [fileName stringByAppendingString:suffix];
+        if ([MSACUtility fileExistsForPathComponent:pathComponent]) {
+            [MSACUtility deleteItemForPathComponent:pathComponent];
+        }
+    }
+}
+
++ (NSArray<NSString *> *)selfCheckFailures {
+    NSMutableArray<NSString *> *failures = [NSMutableArray new];
+    [self removeDatabaseNamed:checksFileName];
+    MSACDBSchema *schema = @{tableName: @[@{@"value": @[kMSACSQLiteTypeInteger, kMSACSQLiteConstraintPrimaryKey]}]};
+    MSACDBStorage *storage = [[MSACDBStorage alloc] initWithSchema:schema version:1 filename:checksFileName];
+    NSString *insertQuery = [NSString stringWithFormat:@"INSERT INTO \"%@\" (\"value\") VALUES (?)", tableName];
+    for (NSUInteger i = 0; i < 3; i++) {
+        [storage executeNonSelectionQuery:insertQuery withValues:[self bindableNumber:i]];
+    }
+    NSString *selectQuery = [NSString stringWithFormat:@"SELECT \"value\" FROM \"%@\"", tableName];
+    [self checkBusyStatementIn:storage query:selectQuery failures:failures];
+    [self checkStatementEvictionIn:storage query:selectQuery failures:failures];
+    [self checkBatchIn:storage insertQuery:insertQuery selectQuery:selectQuery failures:failures];
+    [self checkMaxStorageSizeIn:storage failures:failures];
+    [self checkDropDatabase:storage failures:failures];
+    return failures;
+}
+
++ (MSACStorageBindableArray *)bindableNumber:(NSUInteger)number {
+    MSACStorageBindableArray *values = [MSACStorageBindableArray new];
+    [values addNumber:@(number)];
+    return values;
+}
+
+/// the cached statement is still stepping when the same query runs again from the enumeration
++ (void)checkBusyStatementIn:(MSACDBStorage *)storage query:(NSString *)query failures:(NSMutableArray<NSString *> *)failures {
+    __block NSUInteger outerRows = 0;
+    __block NSUInteger innerRows = 0;
+    [storage enumerateSelectionQuery:query withValues:nil usingBlock:^(__unused void *statement, __unused BOOL *stop) {
+        outerRows++;
+        innerRows += [storage executeSelectionQuery:query withValues:nil].count;
+    }];
+    if (outerRows != 3 || innerRows != 9) {
+        [failures addObject:[NSString stringWithFormat:@"nested query: %tu outer and %tu inner rows, expected 3 and 9", outerRows, innerRows]];
+    }
+    sqlite3_stmt *cached = storage.statementCache[query].pointerValue;
+    if (!cached || sqlite3_stmt_busy(cached)) {
+        [failures addObject:@"nested query: the cached statement is missing or was left stepping"];
+    }
+}
+
++ (void)checkStatementEvictionIn:(MSACDBStorage *)storage query:(NSString *)query failures:(NSMutableArray<NSString *> *)failures {
+    for (NSUInteger i = 0; i < kMSACStatementCacheLimit + 8; i++) {
+        [storage executeSelectionQuery:[NSString stringWithFormat:@"SELECT %tu", i] withValues:nil];
+    }
+    if (storage.statementCache.count > kMSACStatementCacheLimit) {
+        [failures addObject:[NSString stringWithFormat:@"eviction: %tu cached statements, the limit is %tu", storage.statementCache.count, kMSACStatementCacheLimit]];
+    }
+    if ([storage executeSelectionQuery:query withValues:nil].count != 3) {
+        [failures addObject:@"eviction: a query prepared again after eviction returned wrong rows"];
+    }
+}
+
+/// a batch commits all its rows; one whose second row breaks the primary key leaves none behind
++ (void)checkBatchIn:(MSACDBStorage *)storage insertQuery:(NSString *)insertQuery selectQuery:(NSString *)selectQuery failures:(NSMutableArray<NSString *> *)failures {
+    int result = [storage executeNonSelectionQuery:insertQuery withValuesBatch:@[[self bindableNumber:10], [self bindableNumber:11]]];
+    NSUInteger rows = [storage executeSelectionQuery:selectQuery withValues:nil].count;
+    if (result != SQLITE_OK || rows != 5) {
+        [failures addObject:[NSString stringWithFormat:@"batch: result %d and %tu rows, expected %d and 5", result, rows, SQLITE_OK]];
+    }
+    result = [storage executeNonSelectionQuery:insertQuery withValuesBatch:@[[self bindableNumber:20], [self bindableNumber:0], [self bindableNumber:21]]];
+    rows = [storage executeSelectionQuery:selectQuery withValues:nil].count;
+    if (result == SQLITE_OK || rows != 5) {
+        [failures addObject:[NSString stringWithFormat:@"failed batch: result %d and %tu rows, expected an error and 5", result, rows]];
+    }
+    __block BOOL inTransaction = YES;
+    [storage executeQueryUsingBlock:^int(void *db) {
+        inTransaction = !sqlite3_get_autocommit(db);
+        return SQLITE_OK;
+    }];
+    if (inTransaction) {
+        [failures addObject:@"failed batch: the transaction was left open"];
+    }
+}
+
++ (void)checkMaxStorageSizeIn:(MSACDBStorage *)storage failures:(NSMutableArray<NSString *> *)failures {
+    long maxPageCount = storage.maxPageCount;
+    long maxSizeInBytes = storage.maxSizeInBytes;
+    // SQLite clamps a "max_page_count" this large, so the new limit is rejected and the previous one must be restored
+    __block BOOL changed = YES;
+    [storage setMaxStorageSize:LONG_MAX / 2 completionHandler:^(BOOL success) {
+        changed = success;
+    }];
+    __block long enforcedMaxPageCount = 0;
+    [storage executeQueryUsingBlock:^int(void *db) {
+        enforcedMaxPageCount = [MSACDBStorage getMaxPageCountInOpenedDatabase:db];
+        return SQLITE_OK;
+    }];
+    if (changed || enforcedMaxPageCount != maxPageCount || storage.maxPageCount != maxPageCount || storage.maxSizeInBytes != maxSizeInBytes) {
+        [failures addObject:[NSString stringWithFormat:@"rejected size limit: %ld pages enforced and %ld cached, expected %ld", enforcedMaxPageCount, storage.maxPageCount, maxPageCount]];
+    }
+    // an accepted limit is cached for the size check of the next save
+    [storage setMaxStorageSize:maxSizeInBytes * 2 completionHandler:nil];
+    if (storage.maxPageCount != maxPageCount * 2) {
+        [failures addObject:[NSString stringWithFormat:@"accepted size limit: %ld pages cached, expected %ld", storage.maxPageCount, maxPageCount * 2]];
+    }
+}
+
++ (void)checkDropDatabase:(MSACDBStorage *)storage failures:(NSMutableArray<NSString *> *)failures {
+    NSString *path = storage.dbFileURL.path;
+    NSFileManager *fileManager = NSFileManager.defaultManager;
+    if (![fileManager fileExistsAtPath:[path stringByAppendingString:@"-wal"]]) {
+        [failures addObject:@"drop: the open database has no write-ahead log"];
+    }
+    [storage dropDatabase];
+    for (NSString *suffix in @[@"", @"-wal", @"-shm"]) {
+        if ([fileManager fileExistsAtPath:[path stringByAppendingString:suffix]]) {
+            [failures addObject:[NSString stringWithFormat:@"drop: \"%@%@\" is still there", path.lastPathComponent, suffix]];
+        }
+    }
+}
+
+@end
+#endif
@@ -0,0 +1,69 @@
+import Foundation
+
+/// Records the WindowServer pipeline's inputs as a JSONL trace for `WsEventReplay`: raw notify-proc
+/// notifications, every `WindowServerQuery` batch, and how long each AX call attempt took and whether it
+/// failed. Enabled with `--record-ws-trace <path>`; a no-op otherwise (one `isRecording` check per hook).
+/// The hooks fire on any thread; only `writeQueue` touches the file, and `stop` drains it before closing.
+final class WsTraceRecorder {
+    static let flag = "--record-ws-trace"
+    private static var _isRecording: Int32 = 0
+    static var isRecording: Bool { OSAtomicAdd32Barrier(0, &_isRecording) != 0 }
+    private static let writeQueue = DispatchQueue(label: "WsTraceRecorder.writeQueue", qos: .utility)
+    private static var handle: FileHandle?
+    /// written once, before `_isRecording` is set; the barrier publishes it to the threads that see the flag
+    private static var startNs: UInt64 = 0
+
+    static func startIfNeeded() {
+        let args = CommandLine.arguments
+        guard let index = args.firstIndex(of: flag), index + 1 < args.count else { return }
+        let path = args[index + 1]
+        guard FileManager.default.createFile(atPath: path, contents: nil), let h = FileHandle(forWritingAtPath: path) else {
+            Logger.error { "Can't record the WindowServer trace to \(path)" }
+            return
+        }
+        writeQueue.sync { handle = h }
+        startNs = DispatchTime.now().uptimeNanoseconds
+        OSAtomicCompareAndSwap32Barrier(0, 1, &_isRecording)
+        // seed the replay with the windows AltTab already tracks; the query records its own snapshot
+        let wids = Windows.list.compactMap { $0.cgWindowId }
+        writeQueue.async { _ = WindowServerQuery.query(wids) }
+    }
+
+    static func notification(_ code: UInt32, _ w0: UInt32, _ space: UInt64, _ widInSpace: UInt32) {
+        guard isRecording else { return }
+        let t = elapsedNs()
+        writeQueue.async { record(WsTraceEvent(t: t, kind: .notification, code: code, wid: w0, space: space, widInSpace: widInSpace)) }
+    }
+
+    static func snapshot(_ windows: [WsRawWindow]) {
+        guard isRecording else { return }
+        let t = elapsedNs()
+        writeQueue.async { record(.snapshot(t, windows)) }
+    }
+
+    static func axCompletion(key: String, pid: pid_t?, startNs: UInt64, failed: Bool) {
+        guard isRecording else { return }
+        let t = elapsedNs()
+        let durationNs = DispatchTime.now().uptimeNanoseconds - startNs
+        writeQueue.async { record(.axCompletion(t, key: key, pid: pid, durationNs: durationNs, timedOut: failed)) }
+    }
+
+    /// At terminate: stop recording, write out what's still queued, and close the file
+    static func stop() {
+        guard OSAtomicCompareAndSwap32Barrier(1, 0, &_isRecording) else { return }
+        writeQueue.sync {
+            handle?.synchronizeFile()
+            handle?.closeFile()
+            handle = nil
+        }
+    }
+
+    private static func elapsedNs() -> UInt64 {
+        DispatchTime.now().uptimeNanoseconds - startNs
+    }
+
+    private static func record(_ event: WsTraceEvent) {
+        guard let line = try? WsTrace.encodeLine(event) else { return }
+        handle?.write(line)
+    }
+}
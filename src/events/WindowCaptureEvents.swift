@@ -117,6 +117,8 @@ class WindowCaptureScreenshots {
 class WindowCaptureScreenshotsPrivateApi {
     static func oneTimeScreenshots(_ eligibleWindows: [Window], _ source: RefreshCausedBy, prioritizedIds: Set<CGWindowID>? = nil) {
         let prioritized = prioritizedIds ?? []
+        // CGSHWCaptureWindowList returns full-resolution images; we keep them at the largest tile size instead
+        let storageMaxSize = WindowThumbnails.storageMaxSize()
         // iterate prioritized windows first so they enqueue (and grab queue slots) ahead of the rest
         let sorted = eligibleWindows.sorted { a, b in
             let aPri = a.cgWindowId.map { prioritized.contains($0) } ?? false
@@ -128,7 +130,10 @@ class WindowCaptureScreenshotsPrivateApi {
             let isPrioritized = prioritized.contains(wid)
             Applications.screenshotThrottler.throttleOrProceed(key: "capture-wid-\(wid)", queue: BackgroundWork.screenshotsQueue, priority: isPrioritized ? .high : .normal) { [weak window] in
                 guard source != .refreshOnlyThumbnailsAfterShowUi || SwitcherSession.isActive else { return }
-                guard let wid = window?.cgWindowId, let cgImage = oneTimeCapture(wid) else { return }
+                guard let wid = window?.cgWindowId, var cgImage = oneTimeCapture(wid) else { return }
+                if let storageMaxSize, let size = ThumbnailBudget.storageSize(cgImage.size(), fitting: storageMaxSize) {
+                    cgImage = cgImage.resizedCopyWithCoreGraphics(size, true)
+                }
                 guard source != .refreshOnlyThumbnailsAfterShowUi || SwitcherSession.isActive else { return }
                 DispatchQueue.main.async { [weak window] in
                     guard source != .refreshOnlyThumbnailsAfterShowUi || SwitcherSession.isActive else { return }
@@ -302,8 +307,7 @@ extension SCStreamConfiguration {
         // Use full-resolution capture if any shortcut has preview-selected-window enabled (could be
         // the global or a per-shortcut override). Background captures aren't tied to a specific
         // shortcut, so we err on the side of full-res when any shortcut might need it.
-        let anyPreview = (0...Preferences.maxShortcutCount).contains { Preferences.effectivePreviewSelectedWindow($0) }
-        if anyPreview {
+        if WindowThumbnails.anyShortcutPreviewsSelectedWindow {
             width = Int(originalSize.width)
             height = Int(originalSize.height)
         } else {
@@ -121,6 +121,7 @@ class WindowServerEvents {
     }
 
     private static func handle(_ event: UInt32, _ w0: UInt32, _ space: UInt64, _ widInSpace: UInt32) {
+        WsTraceRecorder.notification(event, w0, space, widInSpace)
         guard let n = WsEventRouting.notification(event) else { return }
         switch n {
         case .activeSpaceChanged, .spaceCurrentChanged:
@@ -210,7 +211,9 @@ class WindowServerEvents {
                 } else {
                     // moved/resized/ordered-in for a tracked window → refresh just that window's WindowServer
                     // facts (geometry, fullscreen) from a WS query, NOT an AX read. Coalesced per-wid so a
-                    // resize drag collapses to ≤1 query/200ms.
+                    // resize drag collapses to ≤1 query/200ms. A move/resize also stales its thumbnail, even
+                    // while the switcher is hidden and nothing recaptures it.
+                    if n == .windowMoved || n == .windowResized { WindowThumbnails.markDirty([w0]) }
                     Applications.windowAttributesThrottler.throttleOrProceed(key: "wid-\(w0)-wsstate") {
                         Applications.updateWindowStatesViaWindowServer([w0])
                     }
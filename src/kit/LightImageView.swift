@@ -45,4 +45,14 @@ enum CALayerContents {
             return pixelBuffer?.size()
         }
     }
+
+    /// memory the image's pixels take
+    func byteCount() -> Int {
+        switch self {
+        case .cgImage(let image):
+            return image.map { $0.bytesPerRow * $0.height } ?? 0
+        case .pixelBuffer(let pixelBuffer):
+            return pixelBuffer.map { CVPixelBufferGetDataSize($0) } ?? 0
+        }
+    }
 }
@@ -1,4 +1,4 @@
-import Foundation
+import Cocoa
 
 /// Pure executor for outgoing AX calls. Two jobs, on purpose nothing else:
 ///   1. don't explode threads — calls run on bounded pools (a blocked AX call ties a worker for the 1s
@@ -8,8 +8,13 @@ import Foundation
 ///
 /// It does NOT throttle/coalesce. Coalescing self-flooding inputs (resize/move/title) is the job of an
 /// explicit `Throttler` at the call site (e.g. `Applications.windowAttributesThrottler`). The only
-/// dedup here is per-key in-flight: a second call for a key already running is held as `pendingBlock`
+/// dedup here is per-key in-flight: a second call for a key already running is held (`AxCallKeyState`)
 /// and run once the current one finishes — never two concurrent calls for the same key.
+///
+/// Inside a lane, calls wait in an `AxFairQueue` rather than the pool's FIFO: each worker turn runs the call
+/// the fair queue picks (round-robin across apps, boosted windows first), so one app's 150-window re-scan
+/// can't park another app's focused-window read behind it. Queued calls for closed windows or an ended
+/// switcher session are dropped before they run.
 class AXCallScheduler {
     static let shared = AXCallScheduler()
 
@@ -19,23 +24,19 @@ class AXCallScheduler {
     let axQueryRetryQueue: LabeledOperationQueue
 
     private let lock = NSLock()
-    private var keyStates = [String: KeyState]()
+    private var keyStates = [String: AxCallKeyState<HeldCall>]()
     private var unresponsivePids = Set<pid_t>()
-
-    private enum Phase {
-        case idle
-        case executing
-        case retrying
-    }
-
-    private struct KeyState {
-        var phase: Phase = .idle
-        var retryCount = 0
-        var pendingBlock: (() throws -> Void)?
-        var pendingPid: pid_t?
-        var pendingContext: String?
-        var pendingScan = false
-        var cancelRetries = false
+    private var lanes: [AxQueryRouting.Pool: AxFairQueue<() -> Void>] = [.firstTry: AxFairQueue(), .scan: AxFairQueue(), .retry: AxFairQueue()]
+    private var costs = AxCallCost()
+    private static let pools: [AxQueryRouting.Pool] = [.firstTry, .scan, .retry]
+
+    /// a call held while another for its key is in flight (see `AxCallKeyState`)
+    private struct HeldCall {
+        let pid: pid_t?
+        let context: String
+        let scan: Bool
+        let sessionScoped: Bool
+        let block: () throws -> Void
     }
 
     private init() {
@@ -50,25 +51,17 @@ class AXCallScheduler {
 
     /// Run an outgoing AX call, retrying with backoff if the app is unresponsive. `scan: true` routes the
     /// first attempt to the isolated scan pool so a bulk re-scan can't starve event-driven reads. No
-    /// throttling — coalesce at the call site if the input self-floods.
-    func schedule(key: String, file: String = #file, function: String = #function, line: Int = #line, context: String = "", pid: pid_t? = nil, scan: Bool = false, block: @escaping () throws -> Void) {
+    /// throttling — coalesce at the call site if the input self-floods. `sessionScoped: true` marks work only
+    /// the open switcher needs: it's dropped if still queued when the session ends (see `dropSessionWork`).
+    func schedule(key: String, file: String = #file, function: String = #function, line: Int = #line, context: String = "", pid: pid_t? = nil, scan: Bool = false, sessionScoped: Bool = false, block: @escaping () throws -> Void) {
         lock.lock()
-        var state = keyStates[key] ?? KeyState()
-        switch state.phase {
-        case .idle:
-            state.phase = .executing
-            keyStates[key] = state
-            lock.unlock()
-            submitToQueue(key: key, pid: pid, scan: scan, file: file, function: function, line: line, context: context, block: block)
-        case .executing, .retrying:
-            // a call for this key is already in flight: hold the latest, run it when the current one finishes
-            state.pendingBlock = block
-            state.pendingPid = pid
-            state.pendingContext = context
-            state.pendingScan = scan
-            if state.phase == .retrying { state.cancelRetries = true }
-            keyStates[key] = state
-            lock.unlock()
+        var state = keyStates[key] ?? AxCallKeyState()
+        // a call for this key already in flight holds the latest one, run when the current one finishes
+        let scheduled = state.schedule(HeldCall(pid: pid, context: context, scan: scan, sessionScoped: sessionScoped, block: block))
+        keyStates[key] = state
+        lock.unlock()
+        if case .submit = scheduled {
+            submitToQueue(key: key, pid: pid, scan: scan, sessionScoped: sessionScoped, file: file, function: function, line: line, context: context, block: block)
         }
     }
 
@@ -79,9 +72,11 @@ class AXCallScheduler {
         (scan ? axQueryScanQueue : axQueryFirstTryQueue).addOperation(block)
     }
 
+    /// The key's window/app is gone: forget its state, and drop its calls that haven't started yet
     func removeEntry(key: String) {
         lock.lock()
         keyStates[key] = nil
+        for pool in Self.pools { lanes[pool]!.removeAll { $0.key == key } }
         lock.unlock()
     }
 
@@ -90,32 +85,73 @@ class AXCallScheduler {
         for key in keyStates.keys where key.hasPrefix(prefix) {
             keyStates[key] = nil
         }
+        for pool in Self.pools { lanes[pool]!.removeAll { $0.key.hasPrefix(prefix) } }
         lock.unlock()
     }
 
     func removeUnresponsivePid(_ pid: pid_t) {
         lock.lock()
         unresponsivePids.remove(pid)
+        costs.forget(pid: pid)
         lock.unlock()
     }
 
-    private func queueForPid(_ pid: pid_t?, scan: Bool) -> LabeledOperationQueue {
-        let unresponsive = pid.map { unresponsivePids.contains($0) } ?? false
-        switch AxQueryRouting.pool(unresponsive: unresponsive, scan: scan) {
+    /// Calls for these windows (the selected/hovered/on-screen tiles) run before any other queued call
+    func boost(_ wids: Set<CGWindowID>) {
+        lock.lock()
+        for pool in Self.pools { lanes[pool]!.setBoosted(wids) }
+        lock.unlock()
+    }
+
+    /// The switcher closed: drop its queued `sessionScoped` calls. Their keys go idle, or run their held call.
+    func dropSessionWork() {
+        lock.lock()
+        var dropped = [String]()
+        for pool in Self.pools { dropped += lanes[pool]!.removeAll { $0.sessionScoped }.map { $0.key } }
+        lock.unlock()
+        for key in dropped {
+            drainPending(key: key, file: #file, function: #function, line: #line)
+        }
+    }
+
+    func laneStats() -> [(label: String, stats: AxFairQueue<() -> Void>.Stats)] {
+        lock.lock()
+        defer { lock.unlock() }
+        return [(AxQueryRouting.Pool.firstTry, axQueryFirstTryQueue), (.scan, axQueryScanQueue), (.retry, axQueryRetryQueue)].map {
+            (label: $0.1.strongUnderlyingQueue.label, stats: lanes[$0.0]!.stats)
+        }
+    }
+
+    private func queue(for pool: AxQueryRouting.Pool) -> LabeledOperationQueue {
+        switch pool {
             case .firstTry: return axQueryFirstTryQueue
             case .scan: return axQueryScanQueue
             case .retry: return axQueryRetryQueue
         }
     }
 
-    private func submitToQueue(key: String, pid: pid_t?, scan: Bool, file: String, function: String, line: Int, context: String, block: @escaping () throws -> Void) {
-        let queue = queueForPid(pid, scan: scan)
-        queue.addOperation { [self] in
-            attemptBlock(key: key, pid: pid, file: file, function: function, line: line, context: context, retryStartTime: DispatchTime.now().uptimeNanoseconds, block: block)
+    private func submitToQueue(key: String, pid: pid_t?, scan: Bool, sessionScoped: Bool, file: String, function: String, line: Int, context: String, block: @escaping () throws -> Void) {
+        let unresponsive = pid.map { unresponsivePids.contains($0) } ?? false
+        enqueue(AxQueryRouting.pool(unresponsive: unresponsive, scan: scan), key: key, pid: pid, sessionScoped: sessionScoped) { [self] in
+            attemptBlock(key: key, pid: pid, sessionScoped: sessionScoped, file: file, function: function, line: line, context: context, retryStartTime: DispatchTime.now().uptimeNanoseconds, block: block)
         }
     }
 
-    private func attemptBlock(key: String, pid: pid_t?, file: String, function: String, line: Int, context: String, retryStartTime: UInt64, block: @escaping () throws -> Void) {
+    /// Queue `job` in its lane's fair queue, and give the lane's pool one more worker turn. The turn runs
+    /// whichever call the fair queue picks then — not necessarily this one — or nothing if it was dropped.
+    private func enqueue(_ pool: AxQueryRouting.Pool, key: String, pid: pid_t?, sessionScoped: Bool, job: @escaping () -> Void) {
+        lock.lock()
+        lanes[pool]!.enqueue(job, key: key, pid: pid, costMs: costs.costMs(pid: pid), sessionScoped: sessionScoped)
+        lock.unlock()
+        queue(for: pool).addOperation { [self] in
+            lock.lock()
+            let next = lanes[pool]!.dequeue()
+            lock.unlock()
+            next?.job()
+        }
+    }
+
+    private func attemptBlock(key: String, pid: pid_t?, sessionScoped: Bool, file: String, function: String, line: Int, context: String, retryStartTime: UInt64, block: @escaping () throws -> Void) {
         // check if cancelled by a newer request
         lock.lock()
         if let state = keyStates[key], state.cancelRetries {
@@ -125,89 +161,47 @@ class AXCallScheduler {
         }
         lock.unlock()
 
-        if (try? block()) != nil {
-            // success
-            if let pid {
-                lock.lock()
-                unresponsivePids.remove(pid)
-                lock.unlock()
-            }
-            onComplete(key: key, file: file, function: function, line: line)
-            return
-        }
-
-        // failure
+        let attemptStart = DispatchTime.now().uptimeNanoseconds
+        let succeeded = (try? block()) != nil
+        let attemptEnd = DispatchTime.now().uptimeNanoseconds
+        WsTraceRecorder.axCompletion(key: key, pid: pid, startNs: attemptStart, failed: !succeeded)
+        lock.lock()
+        costs.record(pid: pid, durationNs: attemptEnd - attemptStart)
         if let pid {
-            lock.lock()
-            unresponsivePids.insert(pid)
-            lock.unlock()
+            // a failure quarantines the app: its next calls go to the retry pool
+            if succeeded { unresponsivePids.remove(pid) } else { unresponsivePids.insert(pid) }
         }
+        // a removed key still finishes its retries, from a fresh state it doesn't store
+        var state = keyStates[key] ?? AxCallKeyState()
+        let outcome = state.attemptEnded(succeeded: succeeded, elapsedSinceStartNs: attemptEnd - retryStartTime)
+        if keyStates[key] != nil { keyStates[key] = state }
+        if outcome == .gaveUp, let pid { unresponsivePids.remove(pid) }
+        lock.unlock()
 
-        if RetryPolicy.shouldGiveUp(elapsedSinceStartNs: DispatchTime.now().uptimeNanoseconds - retryStartTime) {
+        switch outcome {
+        case .succeeded:
+            drainPending(key: key, file: file, function: function, line: line)
+        case .gaveUp:
             Logger.info { "AX call timed out after \(RetryPolicy.giveUpAfterNs / 1_000_000_000)s. \(Self.logContext(file, function, line, context))" }
-            if let pid {
-                lock.lock()
-                unresponsivePids.remove(pid)
-                lock.unlock()
+            drainPending(key: key, file: file, function: function, line: line)
+        case .retry(let delayNs):
+            // backoff: 200ms, 1s, 2s, 5s, 5s, ...
+            Logger.debug { "Retrying AX call in \(delayNs / 1_000_000)ms. \(Self.logContext(file, function, line, context))" }
+            axQueryRetryQueue.strongUnderlyingQueue.asyncAfter(deadline: .now() + .nanoseconds(Int(delayNs))) { [self] in
+                enqueue(.retry, key: key, pid: pid, sessionScoped: sessionScoped) { [self] in
+                    attemptBlock(key: key, pid: pid, sessionScoped: sessionScoped, file: file, function: function, line: line, context: context, retryStartTime: retryStartTime, block: block)
+                }
             }
-            onComplete(key: key, file: file, function: function, line: line)
-            return
-        }
-
-        // schedule retry with backoff: 200ms, 1s, 2s, 5s, 5s, ...
-        let delayNs: UInt64
-        lock.lock()
-        if var state = keyStates[key] {
-            state.phase = .retrying
-            delayNs = RetryPolicy.backoffDelayNs(retryCount: state.retryCount)
-            state.retryCount += 1
-            keyStates[key] = state
-        } else {
-            delayNs = RetryPolicy.backoffDelayNs(retryCount: 0)
-        }
-        lock.unlock()
-
-        Logger.debug { "Retrying AX call in \(delayNs / 1_000_000)ms. \(Self.logContext(file, function, line, context))" }
-        axQueryRetryQueue.addOperationAfter(deadline: .now() + .nanoseconds(Int(delayNs))) { [self] in
-            attemptBlock(key: key, pid: pid, file: file, function: function, line: line, context: context, retryStartTime: retryStartTime, block: block)
-        }
-    }
-
-    private func onComplete(key: String, file: String, function: String, line: Int) {
-        lock.lock()
-        if var state = keyStates[key] {
-            state.phase = .idle
-            state.cancelRetries = false
-            state.retryCount = 0
-            keyStates[key] = state
         }
-        lock.unlock()
-        drainPending(key: key, file: file, function: function, line: line)
     }
 
+    /// The key's current call is over, or was cancelled: submit its held call, if any
     private func drainPending(key: String, file: String, function: String, line: Int) {
         lock.lock()
-        guard var state = keyStates[key], let block = state.pendingBlock else {
-            if var state = keyStates[key] {
-                state.cancelRetries = false
-                state.phase = .idle
-                keyStates[key] = state
-            }
-            lock.unlock()
-            return
-        }
-        let pid = state.pendingPid
-        let context = state.pendingContext ?? ""
-        let scan = state.pendingScan
-        state.pendingBlock = nil
-        state.pendingPid = nil
-        state.pendingContext = nil
-        state.pendingScan = false
-        state.cancelRetries = false
-        state.phase = .executing
-        keyStates[key] = state
+        let held = keyStates[key]?.next()
         lock.unlock()
-        submitToQueue(key: key, pid: pid, scan: scan, file: file, function: function, line: line, context: context, block: block)
+        guard let held else { return }
+        submitToQueue(key: key, pid: held.pid, scan: held.scan, sessionScoped: held.sessionScoped, file: file, function: function, line: line, context: held.context, block: held.block)
     }
 
     private static func logContext(_ file: String, _ function: String, _ line: Int, _ context: String) -> String {
@@ -0,0 +1,75 @@
+import Foundation
+
+/// Fixed-capacity single-producer / single-consumer ring: `Logger` gives each logging thread one, and its flush
+/// queue drains them all. Neither side locks or allocates: the producer initializes a slot then publishes
+/// `head`, the consumer moves slots out then publishes `tail`, each behind a memory barrier. When the ring is
+/// full, `push` drops the element and counts it rather than blocking the logging thread.
+///
+/// Only one thread may `push` and only one may `drain`/`takeDropped` (possibly a different one).
+final class LogRing<Element> {
+    let capacity: Int
+    private let mask: Int
+    private let slots: UnsafeMutablePointer<Element>
+    /// slots written by the producer so far; only the producer stores it
+    private let head: UnsafeMutablePointer<Int>
+    /// slots consumed so far; only the consumer stores it
+    private let tail: UnsafeMutablePointer<Int>
+    private let dropped: UnsafeMutablePointer<Int64>
+
+    /// `capacity` is rounded up to a power of 2
+    init(capacity: Int) {
+        var rounded = 1
+        while rounded < capacity { rounded <<= 1 }
+        self.capacity = rounded
+        mask = rounded - 1
+        slots = UnsafeMutablePointer<Element>.allocate(capacity: rounded)
+        head = UnsafeMutablePointer<Int>.allocate(capacity: 1)
+        head.initialize(to: 0)
+        tail = UnsafeMutablePointer<Int>.allocate(capacity: 1)
+        tail.initialize(to: 0)
+        dropped = UnsafeMutablePointer<Int64>.allocate(capacity: 1)
+        dropped.initialize(to: 0)
+    }
+
+    deinit {
+        for i in tail.pointee..<head.pointee { (slots + (i & mask)).deinitialize(count: 1) }
+        slots.deallocate()
+        head.deallocate()
+        tail.deallocate()
+        dropped.deallocate()
+    }
+
+    /// producer side; false (and counted) when the ring is full
+    @discardableResult
+    func push(_ element: Element) -> Bool {
+        let h = head.pointee
+        OSMemoryBarrier()
+        guard h - tail.pointee < capacity else {
+            OSAtomicIncrement64Barrier(dropped)
+            return false
+        }
+        (slots + (h & mask)).initialize(to: element)
+        OSMemoryBarrier()
+        head.pointee = h + 1
+        return true
+    }
+
+    /// consumer side: hands every published element to `body`, oldest first; returns how many
+    @discardableResult
+    func drain(_ body: (Element) -> Void) -> Int {
+        let t = tail.pointee
+        let h = head.pointee
+        OSMemoryBarrier()
+        for i in t..<h { body((slots + (i & mask)).move()) }
+        OSMemoryBarrier()
+        tail.pointee = h
+        return h - t
+    }
+
+    /// consumer side: elements dropped since the last call
+    func takeDropped() -> Int {
+        let n = OSAtomicAdd64Barrier(0, dropped)
+        OSAtomicAdd64Barrier(-n, dropped)
+        return Int(n)
+    }
+}
@@ -0,0 +1,102 @@
+import XCTest
+
+/// Pins the per-thread log ring: FIFO across wrap-around, dropping (and counting) when full instead of
+/// blocking, releasing what it still holds, and a producer and a consumer on two threads seeing every element
+/// exactly once.
+final class LogRingTests: XCTestCase {
+    private final class Tracked {
+        static var alive = 0
+        init() { Tracked.alive += 1 }
+        deinit { Tracked.alive -= 1 }
+    }
+
+    private func drained<T>(_ ring: LogRing<T>) -> [T] {
+        var out = [T]()
+        ring.drain { out.append($0) }
+        return out
+    }
+
+    // MARK: - A. Order and capacity
+
+    func testCapacityRoundsUpToAPowerOfTwo() {
+        XCTAssertEqual(LogRing<Int>(capacity: 5).capacity, 8)
+        XCTAssertEqual(LogRing<Int>(capacity: 8).capacity, 8)
+    }
+
+    func testDrainsInPushOrderAcrossWrapAround() {
+        let ring = LogRing<Int>(capacity: 4)
+        var expected = [Int]()
+        var seen = [Int]()
+        for round in 0..<5 {
+            for i in 0..<3 {
+                XCTAssertTrue(ring.push(round * 10 + i))
+                expected.append(round * 10 + i)
+            }
+            seen += drained(ring)
+        }
+        XCTAssertEqual(seen, expected)
+        XCTAssertEqual(ring.drain { _ in }, 0, "nothing left")
+    }
+
+    func testFullRingDropsAndCounts() {
+        let ring = LogRing<Int>(capacity: 2)
+        XCTAssertTrue(ring.push(1))
+        XCTAssertTrue(ring.push(2))
+        XCTAssertFalse(ring.push(3))
+        XCTAssertFalse(ring.push(4))
+        XCTAssertEqual(ring.takeDropped(), 2)
+        XCTAssertEqual(ring.takeDropped(), 0, "taken once")
+        XCTAssertEqual(drained(ring), [1, 2], "the oldest are kept")
+        XCTAssertTrue(ring.push(5), "room again after a drain")
+    }
+
+    func testReleasesWhatItStillHolds() {
+        var ring: LogRing<Tracked>? = LogRing(capacity: 4)
+        ring!.push(Tracked())
+        ring!.push(Tracked())
+        _ = drained(ring!)
+        ring!.push(Tracked())
+        XCTAssertEqual(Tracked.alive, 1, "drained elements are moved out, not copied")
+        ring = nil
+        XCTAssertEqual(Tracked.alive, 0)
+    }
+
+    // MARK: - B. Two threads
+
+    func testProducerAndConsumerThreadsSeeEveryElementOnce() {
+        let ring = LogRing<Int>(capacity: 64)
+        let count = 200_000
+        // the producer retries when the ring is full, so nothing is lost
+        let producer = Thread {
+            var i = 0
+            while i < count {
+                if ring.push(i) { i += 1 }
+            }
+        }
+        producer.start()
+        var next = 0
+        var outOfOrder = 0
+        while next < count {
+            ring.drain {
+                if $0 != next { outOfOrder += 1 }
+                next += 1
+            }
+        }
+        XCTAssertEqual(next, count)
+        XCTAssertEqual(outOfOrder, 0)
+    }
+
+    // MARK: - C. Benchmarks
+
+    /// the ring's share of an emitted `Logger` call: one push, and its drain on the flush queue
+    func testBenchmarkPushAndDrain() {
+        let ring = LogRing<(UInt64, String)>(capacity: 4096)
+        let message = "window 42 moved"
+        measure {
+            for _ in 0..<100 {
+                for i in 0..<4096 { ring.push((UInt64(i), message)) }
+                XCTAssertEqual(ring.drain { _ in }, 4096)
+            }
+        }
+    }
+}
@@ -0,0 +1,238 @@
+import Foundation
+
+/// The compact binary log format `Logger` writes with `--record-log-trace <path>`, and the text layout both the
+/// console and the trace decoder print. Pure: the caller passes times, thread names and messages.
+///
+/// A trace is a header, then tagged entries, little-endian:
+/// - header: `ATLG`, version, 3 zero bytes, the wall-clock time (`Double`, Unix seconds) at monotonic 0 ns
+/// - `site`: id, line, file, function — written once, the first time a call site logs
+/// - `thread`: id, name — written once per distinct thread name
+/// - `event`: monotonic ns (`CLOCK_MONOTONIC`, counts sleep), level, site id, thread id, message
+/// - `clock`: the wall-clock time at monotonic 0 ns again, re-read when it drifted (NTP, a manual change)
+/// Strings are a `UInt32` byte count then UTF-8. A truncated last entry (the app died mid-write) is ignored.
+enum LogTrace {
+    static let magic: [UInt8] = Array("ATLG".utf8)
+    static let version: UInt8 = 1
+    static let levelWords = ["DEBG", "INFO", "WARN", "ERRO"]
+
+    enum DecodeError: Error {
+        case notATrace
+        case unknownTag(UInt8, offset: Int)
+        case unknownId(UInt32, offset: Int)
+    }
+
+    private enum Tag: UInt8 {
+        case site = 1
+        case thread = 2
+        case event = 3
+        case clock = 4
+    }
+
+    /// One call site, by the addresses of its `#fileID` / `#function` literals: hashing it costs no string work
+    struct SiteKey: Hashable {
+        let file: UInt
+        let function: UInt
+        let line: UInt32
+
+        init(file: StaticString, function: StaticString, line: UInt32) {
+            self.file = Self.identity(file)
+            self.function = Self.identity(function)
+            self.line = line
+        }
+
+        private static func identity(_ s: StaticString) -> UInt {
+            s.hasPointerRepresentation ? UInt(bitPattern: s.utf8Start) : UInt(s.unicodeScalar.value) | 1 << (UInt.bitWidth - 1)
+        }
+    }
+
+    struct Entry: Equatable {
+        var ns: UInt64
+        var level: UInt8
+        var file: String
+        var function: String
+        var line: UInt32
+        var thread: String
+        var message: String
+    }
+
+    /// Appends events to a trace, defining each call site and thread the first time one shows up
+    struct Encoder {
+        private var sites = [SiteKey: UInt32]()
+        private var threads = [String: UInt32]()
+
+        /// the header for a trace whose monotonic 0 ns was `wallClockAtZero` (Unix seconds)
+        static func header(wallClockAtZero: Double) -> Data {
+            var data = Data(magic + [version, 0, 0, 0])
+            append(wallClockAtZero.bitPattern, to: &data)
+            return data
+        }
+
+        init() {}
+
+        /// re-anchors the events after it: the wall clock moved against the monotonic one since the header
+        static func appendClock(wallClockAtZero: Double, to data: inout Data) {
+            data.append(Tag.clock.rawValue)
+            append(wallClockAtZero.bitPattern, to: &data)
+        }
+
+        mutating func append(ns: UInt64, level: UInt8, file: StaticString, function: StaticString, line: UInt32,
+                             thread: String, message: String, to data: inout Data) {
+            let key = SiteKey(file: file, function: function, line: line)
+            let site: UInt32
+            if let known = sites[key] {
+                site = known
+            } else {
+                site = UInt32(sites.count)
+                sites[key] = site
+                data.append(Tag.site.rawValue)
+                Self.append(site, to: &data)
+                Self.append(line, to: &data)
+                Self.append(file.description, to: &data)
+                Self.append(function.description, to: &data)
+            }
+            let threadId: UInt32
+            if let known = threads[thread] {
+                threadId = known
+            } else {
+                threadId = UInt32(threads.count)
+                threads[thread] = threadId
+                data.append(Tag.thread.rawValue)
+                Self.append(threadId, to: &data)
+                Self.append(thread, to: &data)
+            }
+            data.append(Tag.event.rawValue)
+            Self.append(ns, to: &data)
+            data.append(level)
+            Self.append(site, to: &data)
+            Self.append(threadId, to: &data)
+            Self.append(message, to: &data)
+        }
+
+        private static func append<T: FixedWidthInteger>(_ value: T, to data: inout Data) {
+            withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+        }
+
+        private static func append(_ string: String, to data: inout Data) {
+            let utf8 = Array(string.utf8)
+            append(UInt32(utf8.count), to: &data)
+            data.append(contentsOf: utf8)
+        }
+    }
+
+    /// the events of a trace, and the wall-clock time at their monotonic 0 ns. Events after a `clock` record
+    /// get its drift from the header's clock folded into their `ns`, so one `wallClockAtZero` dates them all.
+    static func decode(_ data: Data) throws -> (wallClockAtZero: Double, entries: [Entry]) {
+        var reader = Reader(bytes: [UInt8](data))
+        guard reader.take(magic.count) == magic, reader.take(4) == [version, 0, 0, 0], let clock: UInt64 = reader.integer() else {
+            throw DecodeError.notATrace
+        }
+        let headerClock = Double(bitPattern: clock)
+        var driftNs = Int64(0)
+        var sites = [UInt32: (file: String, function: String, line: UInt32)]()
+        var threads = [UInt32: String]()
+        var entries = [Entry]()
+        reading: while let rawTag = reader.take(1)?.first {
+            let tagOffset = reader.offset - 1
+            guard let tag = Tag(rawValue: rawTag) else { throw DecodeError.unknownTag(rawTag, offset: tagOffset) }
+            // a field missing means the last entry was cut short: keep what came before it
+            switch tag {
+                case .site:
+                    guard let id: UInt32 = reader.integer(), let line: UInt32 = reader.integer(),
+                          let file = reader.string(), let function = reader.string() else { break reading }
+                    sites[id] = (file, function, line)
+                case .thread:
+                    guard let id: UInt32 = reader.integer(), let name = reader.string() else { break reading }
+                    threads[id] = name
+                case .event:
+                    guard let ns: UInt64 = reader.integer(), let level = reader.take(1)?.first,
+                          let siteId: UInt32 = reader.integer(), let threadId: UInt32 = reader.integer(),
+                          let message = reader.string() else { break reading }
+                    guard let site = sites[siteId] else { throw DecodeError.unknownId(siteId, offset: tagOffset) }
+                    guard let thread = threads[threadId] else { throw DecodeError.unknownId(threadId, offset: tagOffset) }
+                    let shifted = driftNs < 0 ? ns - min(ns, UInt64(-driftNs)) : ns + UInt64(driftNs)
+                    entries.append(Entry(ns: shifted, level: level, file: site.file, function: site.function, line: site.line,
+                        thread: thread, message: message))
+                case .clock:
+                    guard let anchor: UInt64 = reader.integer() else { break reading }
+                    driftNs = Int64(((Double(bitPattern: anchor) - headerClock) * 1_000_000_000).rounded())
+            }
+        }
+        return (headerClock, entries)
+    }
+
+    /// `HH:mm:ss.SSS` of a local time of day, in milliseconds (wraps past midnight)
+    static func clock(msOfDay: Int64) -> String {
+        let ms = ((msOfDay % 86_400_000) + 86_400_000) % 86_400_000
+        return pad(ms / 3_600_000, 2) + ":" + pad(ms / 60_000 % 60, 2) + ":" + pad(ms / 1000 % 60, 2) + "." + pad(ms % 1000, 3)
+    }
+
+    /// the local time of day of `ns` (monotonic), in milliseconds, for `clock(msOfDay:)`
+    static func msOfDay(ns: UInt64, wallClockAtZero: Double, secondsFromGMT: Int) -> Int64 {
+        Int64(((wallClockAtZero + Double(ns) / 1_000_000_000 + Double(secondsFromGMT)) * 1000).rounded(.down))
+    }
+
+    /// `12:00:00.000 INFO`, what the console colors by level
+    static func head(clock: String, level: UInt8) -> String {
+        clock + " " + word(level)
+    }
+
+    /// `File.swift:12 function() [thread] message`; `site` is `siteText` (cached per call site by the caller)
+    static func body(site: String, thread: String, message: String) -> String {
+        site + " [" + thread + "] " + message
+    }
+
+    /// `File.swift:12 function()` from `#fileID` ("Module/File.swift") and `#function`
+    static func siteText(file: String, function: String, line: UInt32) -> String {
+        let fileName = file.split(separator: "/").last.map(String.init) ?? file
+        return "\(fileName):\(line) \(cleanFunctionName(function))"
+    }
+
+    /// a decoded event as the console printed it (uncolored)
+    static func text(_ entry: Entry, wallClockAtZero: Double, secondsFromGMT: Int) -> String {
+        let ms = msOfDay(ns: entry.ns, wallClockAtZero: wallClockAtZero, secondsFromGMT: secondsFromGMT)
+        return head(clock: clock(msOfDay: ms), level: entry.level) + " "
+            + body(site: siteText(file: entry.file, function: entry.function, line: entry.line), thread: entry.thread, message: entry.message)
+    }
+
+    /// Swift's #function returns the full signature, including "_:" placeholders for unnamed
+    /// parameters (e.g. "init(_:_:_:_:)"). Strip those — the log already has file:line, the
+    /// arity is noise. Functions with labeled arguments keep their labels.
+    static func cleanFunctionName(_ s: String) -> String {
+        guard let open = s.firstIndex(of: "("), let close = s.lastIndex(of: ")"), open < close else { return s }
+        let args = s[s.index(after: open)..<close]
+        if args.isEmpty || args.allSatisfy({ $0 == "_" || $0 == ":" }) {
+            return "\(s[..<open])()"
+        }
+        return s
+    }
+
+    private static func word(_ level: UInt8) -> String {
+        Int(level) < levelWords.count ? levelWords[Int(level)] : "L\(level)"
+    }
+
+    private static func pad(_ n: Int64, _ width: Int) -> String {
+        let digits = String(n)
+        return digits.count >= width ? digits : String(repeating: "0", count: width - digits.count) + digits
+    }
+
+    private struct Reader {
+        let bytes: [UInt8]
+        var offset = 0
+
+        mutating func take(_ count: Int) -> [UInt8]? {
+            guard count <= bytes.count - offset else { return nil }
+            defer { offset += count }
+            return Array(bytes[offset..<offset + count])
+        }
+
+        mutating func integer<T: FixedWidthInteger>() -> T? {
+            guard let raw = take(MemoryLayout<T>.size) else { return nil }
+            return raw.reversed().reduce(T.zero) { $0 << 8 | T($1) }
+        }
+
+        mutating func string() -> String? {
+            guard let count: UInt32 = integer(), let utf8 = take(Int(count)) else { return nil }
+            return String(decoding: utf8, as: UTF8.self)
+        }
+    }
+}
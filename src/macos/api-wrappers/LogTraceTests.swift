@@ -0,0 +1,107 @@
+import XCTest
+
+/// Pins the binary log trace (round trip, call sites and threads written once, a cut-short tail, foreign
+/// files) and the text layout the console and the decoder share.
+final class LogTraceTests: XCTestCase {
+    private let wallClock = 1_700_000_000.25
+
+    private func record(_ encoder: inout LogTrace.Encoder, _ data: inout Data, ns: UInt64, thread: String, message: String, line: UInt32 = 12) {
+        encoder.append(ns: ns, level: 1, file: "AltTab/Windows.swift", function: "refresh(_:)", line: line,
+            thread: thread, message: message, to: &data)
+    }
+
+    // MARK: - A. Binary trace
+
+    func testRoundTripsEvents() throws {
+        var encoder = LogTrace.Encoder()
+        var data = LogTrace.Encoder.header(wallClockAtZero: wallClock)
+        record(&encoder, &data, ns: 5, thread: "main", message: "one")
+        record(&encoder, &data, ns: 9, thread: "axCallsQueue", message: "deux ✓", line: 40)
+        let trace = try LogTrace.decode(data)
+        XCTAssertEqual(trace.wallClockAtZero, wallClock)
+        XCTAssertEqual(trace.entries, [
+            LogTrace.Entry(ns: 5, level: 1, file: "AltTab/Windows.swift", function: "refresh(_:)", line: 12, thread: "main", message: "one"),
+            LogTrace.Entry(ns: 9, level: 1, file: "AltTab/Windows.swift", function: "refresh(_:)", line: 40, thread: "axCallsQueue", message: "deux ✓"),
+        ])
+    }
+
+    func testCallSitesAndThreadsAreWrittenOnce() {
+        var encoder = LogTrace.Encoder()
+        var first = Data()
+        var second = Data()
+        record(&encoder, &first, ns: 1, thread: "main", message: "m")
+        record(&encoder, &second, ns: 2, thread: "main", message: "m")
+        // tag, ns, level, site id, thread id, message length + byte
+        XCTAssertEqual(second.count, 1 + 8 + 1 + 4 + 4 + 4 + 1)
+        XCTAssertGreaterThan(first.count, second.count)
+    }
+
+    func testCutShortLastEventIsIgnored() throws {
+        var encoder = LogTrace.Encoder()
+        var data = LogTrace.Encoder.header(wallClockAtZero: wallClock)
+        record(&encoder, &data, ns: 1, thread: "main", message: "kept")
+        record(&encoder, &data, ns: 2, thread: "main", message: "cut short")
+        let trace = try LogTrace.decode(data.dropLast(3))
+        XCTAssertEqual(trace.entries.map { $0.message }, ["kept"])
+    }
+
+    func testClockRecordReanchorsLaterEvents() throws {
+        var encoder = LogTrace.Encoder()
+        var data = LogTrace.Encoder.header(wallClockAtZero: wallClock)
+        record(&encoder, &data, ns: 5, thread: "main", message: "before")
+        LogTrace.Encoder.appendClock(wallClockAtZero: wallClock + 0.5, to: &data)
+        record(&encoder, &data, ns: 9, thread: "main", message: "after")
+        LogTrace.Encoder.appendClock(wallClockAtZero: wallClock - 1, to: &data)
+        record(&encoder, &data, ns: 2_000_000_000, thread: "main", message: "set back")
+        let trace = try LogTrace.decode(data)
+        XCTAssertEqual(trace.wallClockAtZero, wallClock)
+        XCTAssertEqual(trace.entries.map { $0.ns }, [5, 500_000_009, 1_000_000_000])
+    }
+
+    func testRejectsWhatIsNotATrace() {
+        XCTAssertThrowsError(try LogTrace.decode(Data("12:00:00.000 INFO hello".utf8)))
+        XCTAssertThrowsError(try LogTrace.decode(Data()))
+        var data = LogTrace.Encoder.header(wallClockAtZero: wallClock)
+        data.append(9)
+        XCTAssertThrowsError(try LogTrace.decode(data), "unknown entry tag")
+    }
+
+    // MARK: - B. Text
+
+    func testClockIsTheLocalTimeOfDay() {
+        XCTAssertEqual(LogTrace.clock(msOfDay: 0), "00:00:00.000")
+        XCTAssertEqual(LogTrace.clock(msOfDay: ((13 * 60 + 4) * 60 + 5) * 1000 + 67), "13:04:05.067")
+        XCTAssertEqual(LogTrace.clock(msOfDay: 86_400_000 + 1), "00:00:00.001", "wraps past midnight")
+        XCTAssertEqual(LogTrace.clock(msOfDay: -1), "23:59:59.999")
+        // 1_700_000_000.25 is 22:13:20.250 UTC
+        let ms = LogTrace.msOfDay(ns: 1_500_000_000, wallClockAtZero: wallClock, secondsFromGMT: 3600)
+        XCTAssertEqual(LogTrace.clock(msOfDay: ms), "23:13:21.750")
+    }
+
+    func testLineMatchesTheConsoleLayout() {
+        let entry = LogTrace.Entry(ns: 0, level: 3, file: "AltTab/Windows.swift", function: "refresh(_:_:)", line: 12, thread: "main", message: "boom")
+        let text = LogTrace.text(entry, wallClockAtZero: 0, secondsFromGMT: 0)
+        XCTAssertEqual(text, "00:00:00.000 ERRO Windows.swift:12 refresh() [main] boom")
+    }
+
+    func testCleanFunctionNameDropsUnnamedArguments() {
+        XCTAssertEqual(LogTrace.cleanFunctionName("init(_:_:_:_:)"), "init()")
+        XCTAssertEqual(LogTrace.cleanFunctionName("refresh()"), "refresh()")
+        XCTAssertEqual(LogTrace.cleanFunctionName("show(_:animated:)"), "show(_:animated:)", "labels are kept")
+        XCTAssertEqual(LogTrace.cleanFunctionName("body"), "body")
+    }
+
+    // MARK: - C. Benchmarks
+
+    /// what `--record-log-trace` costs the flush queue per batch of a window storm
+    func testBenchmarkEncode10kEvents() {
+        measure {
+            var encoder = LogTrace.Encoder()
+            var data = Data()
+            for i in 0..<10_000 {
+                record(&encoder, &data, ns: UInt64(i), thread: i % 2 == 0 ? "main" : "axCallsQueue", message: "window \(i) moved")
+            }
+            XCTAssertGreaterThan(data.count, 0)
+        }
+    }
+}
@@ -8,14 +8,7 @@ enum LogLevel: Int, Comparable {
 
     static func < (a: LogLevel, b: LogLevel) -> Bool { a.rawValue < b.rawValue }
 
-    var word: String {
-        switch self {
-            case .debug: return "DEBG"
-            case .info: return "INFO"
-            case .warning: return "WARN"
-            case .error: return "ERRO"
-        }
-    }
+    var word: String { LogTrace.levelWords[rawValue] }
 
     /// xterm-256 color codes that match SwiftyBeaver's defaults (useTerminalColors = true).
     var ansiColorStart: String {
@@ -28,20 +21,56 @@ enum LogLevel: Int, Comparable {
     }
 }
 
+/// One log call as its thread leaves it in its `LogRing`: the message is rendered (the closure may read state
+/// only safe on the calling thread), everything else stays raw until the flush queue needs text or trace bytes.
+struct LogRecord {
+    let ns: UInt64
+    let level: LogLevel
+    let file: StaticString
+    let function: StaticString
+    let line: UInt32
+    let thread: String
+    let message: String
+}
+
+/// Logging backend. A call below `minLevel` costs one comparison. Otherwise the calling thread renders the
+/// message and pushes a `LogRecord` into its own `LogRing` (no lock, no GCD block, no date or string
+/// formatting), and the first push after a flush schedules the next one. Every `flushIntervalMs`, `flushQueue`
+/// drains all rings in one batch, orders it by time, and only then formats: text for the console and the
+/// `DebugWindow` tap, plus `LogTrace` bytes of every record with `--record-log-trace <path>`. Decode such a
+/// trace offline with `--decode-log-trace <path>`.
 class Logger {
     static let flag = "--logs="
+    static let recordTraceFlag = "--record-log-trace"
+    static let decodeTraceFlag = "--decode-log-trace"
     static var minLevel: LogLevel = .error
+    /// what the console prints; the `DebugWindow` lowers `minLevel` without flooding the console
+    private static var consoleLevel: LogLevel = .error
     private static var tap: ((LogLevel, String) -> Void)?
     private static let ansiReset = "\u{001B}[0m"
-    private static let writeQueue = DispatchQueue(label: "Logger.writeQueue", qos: .utility)
-    private static let dateFormatter: DateFormatter = {
-        let f = DateFormatter()
-        f.dateFormat = "HH:mm:ss.SSS"
-        return f
+    private static let flushQueue = DispatchQueue(label: "Logger.flushQueue", qos: .utility)
+    private static let flushIntervalMs = 20
+    /// per thread; at 20ms flushes, a thread has to log over 200k lines/s to drop any
+    private static let ringCapacity = 4096
+    private static var flushScheduled: Int32 = 0
+    private static let rings = ConcurrentArray<ThreadRing>()
+    private static let ringKey: pthread_key_t = {
+        var key = pthread_key_t()
+        // a thread exiting retires its ring; the next flush drains it and lets it go
+        pthread_key_create(&key) { Unmanaged<ThreadRing>.fromOpaque($0).takeRetainedValue().retire() }
+        return key
     }()
+    /// the wall clock can move against the monotonic one (NTP, a manual change): re-read on every flush
+    private static let reanchorThreshold = 0.001
+    // flushQueue only
+    private static var wallClockAtZero = currentWallClockAtZero()
+    private static var trace: (handle: FileHandle, encoder: LogTrace.Encoder)?
+    private static var siteTexts = [LogTrace.SiteKey: String]()
 
     static func initialize() {
-        minLevel = decideLevel()
+        consoleLevel = decideLevel()
+        minLevel = consoleLevel
+        startTraceIfNeeded()
     }
 
     static func decideLevel() -> LogLevel {
@@ -55,66 +84,217 @@ class Logger {
         }
     }
 
-    static func setTap(_ tap: ((LogLevel, String) -> Void)?) { self.tap = tap }
+    static func setTap(_ tap: ((LogLevel, String) -> Void)?) {
+        flushQueue.async { self.tap = tap }
+    }
 
-    static func debug(_ message: @escaping () -> Any?, file: String = #fileID, function: String = #function, line: Int = #line) {
+    static func debug(_ message: @escaping () -> Any?, file: StaticString = #fileID, function: StaticString = #function, line: Int = #line) {
         emit(.debug, message, file, function, line)
     }
 
-    static func info(_ message: @escaping () -> Any?, file: String = #fileID, function: String = #function, line: Int = #line) {
+    static func info(_ message: @escaping () -> Any?, file: StaticString = #fileID, function: StaticString = #function, line: Int = #line) {
         emit(.info, message, file, function, line)
     }
 
-    static func warning(_ message: @escaping () -> Any?, file: String = #fileID, function: String = #function, line: Int = #line) {
+    static func warning(_ message: @escaping () -> Any?, file: StaticString = #fileID, function: StaticString = #function, line: Int = #line) {
         emit(.warning, message, file, function, line)
     }
 
-    static func error(_ message: @escaping () -> Any?, file: String = #fileID, function: String = #function, line: Int = #line) {
+    static func error(_ message: @escaping () -> Any?, file: StaticString = #fileID, function: StaticString = #function, line: Int = #line) {
         emit(.error, message, file, function, line)
     }
 
+    /// writes out what's still in the rings; for exits that skip the next scheduled flush
+    static func flushNow() {
+        flushQueue.sync { flush() }
+    }
+
+    /// `--decode-log-trace <path>`: prints the trace as the console would have, then exits
+    static func decodeTraceAndExitIfAsked() {
+        let args = CommandLine.arguments
+        guard let index = args.firstIndex(of: decodeTraceFlag), index + 1 < args.count else { return }
+        let path = args[index + 1]
+        do {
+            let trace = try LogTrace.decode(Data(contentsOf: URL(fileURLWithPath: path)))
+            let secondsFromGMT = TimeZone.current.secondsFromGMT()
+            for entry in trace.entries {
+                print(LogTrace.text(entry, wallClockAtZero: trace.wallClockAtZero, secondsFromGMT: secondsFromGMT))
+            }
+            exit(0)
+        } catch {
+            print("Can't decode the log trace \(path): \(error)")
+            exit(1)
+        }
+    }
+
     @inline(__always)
-    private static func emit(_ level: LogLevel, _ message: () -> Any?, _ file: String, _ function: String, _ line: Int) {
+    private static func emit(_ level: LogLevel, _ message: () -> Any?, _ file: StaticString, _ function: StaticString, _ line: Int) {
         // Compile-cheap gate: skip the closure call entirely when this level is suppressed.
         guard level >= minLevel else { return }
-        let rendered = "\(message() ?? "nil")"
-        let now = Date()
-        let thread = threadName()
-        // Move formatting + IO off the calling thread (typically main on the hot path).
-        writeQueue.async {
-            let fileName = (file as NSString).lastPathComponent
-            // SwiftyBeaver console.format was: "$C$D{HH:mm:ss.SSS}$d $L$c $N.swift:$l $F $M"
-            // with $M wrapped as "[\(threadName())] \(message())".
-            let timestamp = dateFormatter.string(from: now)
-            let head = "\(timestamp) \(level.word)"
-            let body = "\(fileName):\(line) \(cleanFunctionName(function)) [\(thread)] \(rendered)"
+        let ring = currentRing()
+        ring.push(LogRecord(ns: now(), level: level, file: file, function: function, line: UInt32(truncatingIfNeeded: line),
+            thread: ring.threadName(), message: "\(message() ?? "nil")"))
+        if OSAtomicCompareAndSwap32Barrier(0, 1, &flushScheduled) {
+            flushQueue.asyncAfter(deadline: .now() + .milliseconds(flushIntervalMs)) { flush() }
+        }
+    }
+
+    private static func currentRing() -> ThreadRing {
+        if let ring = pthread_getspecific(ringKey) {
+            return Unmanaged<ThreadRing>.fromOpaque(ring).takeUnretainedValue()
+        }
+        let ring = ThreadRing(capacity: ringCapacity)
+        pthread_setspecific(ringKey, Unmanaged.passRetained(ring).toOpaque())
+        rings.withLock { $0.append(ring) }
+        return ring
+    }
+
+    /// monotonic, counting sleep, so `wallClockAtZero` + `ns` stays the wall-clock time across sleeps. On
+    /// Darwin that's `CLOCK_MONOTONIC` (`mach_continuous_time`); `CLOCK_MONOTONIC_RAW` stops while asleep.
+    private static func now() -> UInt64 {
+        clock_gettime_nsec_np(CLOCK_MONOTONIC)
+    }
+
+    private static func currentWallClockAtZero() -> Double {
+        Date().timeIntervalSince1970 - Double(now()) / 1_000_000_000
+    }
+
+    private static func startTraceIfNeeded() {
+        let args = CommandLine.arguments
+        guard let index = args.firstIndex(of: recordTraceFlag), index + 1 < args.count else { return }
+        let path = args[index + 1]
+        flushQueue.async {
+            guard FileManager.default.createFile(atPath: path, contents: LogTrace.Encoder.header(wallClockAtZero: wallClockAtZero)),
+                  let handle = FileHandle(forWritingAtPath: path) else {
+                Logger.error { "Can't record the log trace to \(path)" }
+                return
+            }
+            handle.seekToEndOfFile()
+            trace = (handle, LogTrace.Encoder())
+        }
+    }
+
+    private static func flush() {
+        // cleared first: a push from here on schedules the next flush, a push before it is drained below
+        OSAtomicCompareAndSwap32Barrier(1, 0, &flushScheduled)
+        var batch = [LogRecord]()
+        var dropped = 0
+        for ring in rings.withLock({ $0 }) {
+            // a retired ring gets no more pushes: once drained, it can go
+            let isRetired = ring.isRetired
+            ring.drain { batch.append($0) }
+            dropped += ring.takeDropped()
+            if isRetired { rings.withLock { $0.removeAll { $0 === ring } } }
+        }
+        guard !batch.isEmpty || dropped > 0 else { return }
+        reanchorWallClock()
+        // each ring is in time order already; ties across threads keep ring order
+        let ordered = batch.indices.sorted { (batch[$0].ns, $0) < (batch[$1].ns, $1) }.map { batch[$0] }
+        if trace != nil {
+            writeTrace(ordered)
+        }
+        writeText(ordered)
+        if dropped > 0 {
+            print("\(LogLevel.warning.ansiColorStart)\(LogLevel.warning.word)\(ansiReset) Logger dropped \(dropped) lines: a thread filled its ring between flushes")
+        }
+    }
+
+    /// the batch is dated with the wall clock as of this flush; a trace gets a `clock` record when it moved
+    private static func reanchorWallClock() {
+        let anchor = currentWallClockAtZero()
+        guard abs(anchor - wallClockAtZero) >= reanchorThreshold else { return }
+        wallClockAtZero = anchor
+        if let trace {
+            var data = Data()
+            LogTrace.Encoder.appendClock(wallClockAtZero: anchor, to: &data)
+            trace.handle.write(data)
+        }
+    }
+
+    private static func writeTrace(_ records: [LogRecord]) {
+        var data = Data()
+        for record in records {
+            trace!.encoder.append(ns: record.ns, level: UInt8(record.level.rawValue), file: record.file, function: record.function,
+                line: record.line, thread: record.thread, message: record.message, to: &data)
+        }
+        trace!.handle.write(data)
+    }
+
+    /// formats only the records someone reads: the console's level and up, all for the tap
+    private static func writeText(_ records: [LogRecord]) {
+        let secondsFromGMT = TimeZone.current.secondsFromGMT()
+        var console = ""
+        for record in records {
+            let printed = record.level >= consoleLevel
+            guard printed || tap != nil else { continue }
+            let ms = LogTrace.msOfDay(ns: record.ns, wallClockAtZero: wallClockAtZero, secondsFromGMT: secondsFromGMT)
+            let head = LogTrace.head(clock: LogTrace.clock(msOfDay: ms), level: UInt8(record.level.rawValue))
+            let body = LogTrace.body(site: siteText(record), thread: record.thread, message: record.message)
             // Always emit ANSI colors — matches SwiftyBeaver's useTerminalColors=true behavior.
             // Modern terminals (Terminal.app, iTerm2, VS Code, etc.) all render them; logs piped
             // to files keep the codes harmlessly inline.
-            print("\(level.ansiColorStart)\(head)\(ansiReset) \(body)")
-            if let tap {
-                // DebugWindow already does its own per-level coloring; pass the uncolored line.
-                tap(level, "\(head) \(body)")
-            }
+            if printed { console += "\(record.level.ansiColorStart)\(head)\(ansiReset) \(body)\n" }
+            // DebugWindow already does its own per-level coloring; pass the uncolored line.
+            tap?(record.level, "\(head) \(body)")
         }
+        if !console.isEmpty { print(console, terminator: "") }
     }
 
-    /// Swift's #function returns the full signature, including "_:" placeholders for unnamed
-    /// parameters (e.g. "init(_:_:_:_:)"). Strip those — the log already has file:line, the
-    /// arity is noise. Functions with labeled arguments keep their labels.
-    private static func cleanFunctionName(_ s: String) -> String {
-        guard let open = s.firstIndex(of: "("), let close = s.lastIndex(of: ")"), open < close else { return s }
-        let args = s[s.index(after: open)..<close]
-        if args.isEmpty || args.allSatisfy({ $0 == "_" || $0 == ":" }) {
-            return "\(s[..<open])()"
+    private static func siteText(_ record: LogRecord) -> String {
+        let key = LogTrace.SiteKey(file: record.file, function: record.function, line: record.line)
+        if let text = siteTexts[key] { return text }
+        let text = LogTrace.siteText(file: record.file.description, function: record.function.description, line: record.line)
+        siteTexts[key] = text
+        return text
+    }
+}
+
+/// A thread's `LogRing`, and its name as the log shows it
+private final class ThreadRing {
+    private let ring: LogRing<LogRecord>
+    /// "main", or the thread's own name; nil for GCD workers, which show the label of the queue they run
+    private let fixedName: String?
+    private var lastLabel: UnsafePointer<CChar>?
+    private var lastLabelName = ""
+    private let retired: UnsafeMutablePointer<Int32> = {
+        let p = UnsafeMutablePointer<Int32>.allocate(capacity: 1)
+        p.initialize(to: 0)
+        return p
+    }()
+
+    init(capacity: Int) {
+        ring = LogRing(capacity: capacity)
+        if Thread.isMainThread {
+            fixedName = "main"
+        } else if let name = Thread.current.name, !name.isEmpty {
+            fixedName = name
+        } else {
+            fixedName = nil
         }
-        return s
     }
 
-    private static func threadName() -> String {
-        if Thread.isMainThread { return "main" }
-        if let name = Thread.current.name, !name.isEmpty { return name }
+    deinit {
+        retired.deallocate()
+    }
+
+    var isRetired: Bool { OSAtomicAdd32Barrier(0, retired) != 0 }
+
+    func retire() { OSAtomicCompareAndSwap32Barrier(0, 1, retired) }
+
+    func push(_ record: LogRecord) { ring.push(record) }
+
+    func drain(_ body: (LogRecord) -> Void) { ring.drain(body) }
+
+    func takeDropped() -> Int { ring.takeDropped() }
+
+    /// producer side; the queue label is only turned into a String when it changes
+    func threadName() -> String {
+        if let fixedName { return fixedName }
         let label = __dispatch_queue_get_label(nil)
-        return String(cString: label, encoding: .utf8) ?? Thread.current.description
+        if label != lastLabel {
+            lastLabel = label
+            lastLabelName = String(cString: label, encoding: .utf8) ?? Thread.current.description
+        }
+        return lastLabelName
     }
 }
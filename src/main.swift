@@ -1,6 +1,8 @@
 import AppKit
 import Darwin
 
+Logger.decodeTraceAndExitIfAsked()
+
 if let command = CliClient.detectCommand() {
     CliClient.sendCommandAndProcessResponse(command)
 }
@@ -43,6 +43,8 @@ class Preferences {
             "hideStatusIcons": "false",
             "previewFocusedWindow": "false",
             "captureWindowsInBackground": "true",
+            "thumbnailCacheBudgetMb": "512",
+            "thumbnailReuseSeconds": "30",
             "screenRecordingPermissionSkipped": "false",
             "trackpadHapticFeedbackEnabled": "true",
             "settingsWindowShownOnFirstLaunch": "false",
@@ -120,6 +122,10 @@ class Preferences {
     static var exceptions: [ExceptionEntry] { CachedUserDefaults.json("exceptions", [ExceptionEntry].self) }
     static var previewSelectedWindow: Bool { CachedUserDefaults.bool("previewFocusedWindow") }
     static var captureWindowsInBackground: Bool { CachedUserDefaults.bool("captureWindowsInBackground") }
+    // no UI: `defaults write com.lwouis.alt-tab-macos thumbnailCacheBudgetMb <MB>`
+    static var thumbnailCacheBudgetBytes: Int { CachedUserDefaults.int("thumbnailCacheBudgetMb") * 1_048_576 }
+    // no UI: `defaults write com.lwouis.alt-tab-macos thumbnailReuseSeconds <seconds>`
+    static var thumbnailReuseWindowNs: UInt64 { UInt64(max(0, CachedUserDefaults.int("thumbnailReuseSeconds"))) * 1_000_000_000 }
     static var screenRecordingPermissionSkipped: Bool { CachedUserDefaults.bool("screenRecordingPermissionSkipped") }
     static var settingsWindowShownOnFirstLaunch: Bool { CachedUserDefaults.bool("settingsWindowShownOnFirstLaunch") }
 
@@ -97,14 +97,22 @@ class DebugProfile {
     private static func resourcesUtilization() -> String {
         let topOutput = Bash.command("top -pid " + String(ProcessInfo.processInfo.processIdentifier) + " -l 2 -stats \"cpu,mem,threads\" | tail -n 1") ?? ""
         let metrics = topOutput.split(separator: " ")
+        var lines = [String]()
         if metrics.count >= 3 {
-            return nestedSeparator + [
+            lines += [
                 "CPU\(intraSeparator)\(metrics[0])%",
                 "Memory\(intraSeparator)\(metrics[1])",
                 "Threads count\(intraSeparator)\(metrics[2])",
-            ].joined(separator: nestedSeparator)
+            ]
         }
-        return ""
+        let thumbnails = WindowThumbnails.budgetStats
+        let bytes = { (count: Int) in ByteCountFormatter.string(fromByteCount: Int64(count), countStyle: .memory) }
+        lines += [
+            "Thumbnails held\(intraSeparator)\(thumbnails.entries) (\(bytes(thumbnails.bytesHeld)) of \(bytes(WindowThumbnails.budgetBytes)))",
+            "Thumbnail hit rate\(intraSeparator)\(String(format: "%.0f", thumbnails.hitRate * 100))%",
+            "Thumbnail evictions\(intraSeparator)\(thumbnails.evictions)",
+        ]
+        return nestedSeparator + lines.joined(separator: nestedSeparator)
     }
 
     static func inputSource() -> String {
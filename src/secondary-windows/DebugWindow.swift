@@ -24,6 +24,8 @@ class DebugWindow: NSPanel {
     private var inspectTimer: Timer?
     private var inspectClickMonitor: Any?
     private var isInspecting = false
+    private var axLanesField: NSTextField!
+    private var axLanesTimer: Timer?
     private static let logFont = NSFont.userFixedPitchFont(ofSize: 11)!
     private static let levels: [LogLevel] = [.debug, .info, .warning, .error]
     private static let defaultAttrs: [NSAttributedString.Key: Any] = [.font: logFont, .foregroundColor: NSColor.labelColor]
@@ -80,6 +82,12 @@ class DebugWindow: NSPanel {
         inspectColumns.alignment = .top
         inspectColumns.spacing = 16
         inspectColumns.distribution = .fillEqually
+        // AX scheduler lanes
+        axLanesField = NSTextField(labelWithString: Self.formatAxLanes())
+        axLanesField.translatesAutoresizingMaskIntoConstraints = false
+        axLanesField.font = Self.logFont
+        axLanesField.isSelectable = true
+        axLanesField.maximumNumberOfLines = 0
         // Log header and filter
         let filterLabel = NSTextField(labelWithString: "Log Level:")
         filterLabel.translatesAutoresizingMaskIntoConstraints = false
@@ -150,6 +158,18 @@ class DebugWindow: NSPanel {
             inspectColumns.trailingAnchor.constraint(equalTo: inspectBox.contentView!.trailingAnchor, constant: -4),
             inspectColumns.bottomAnchor.constraint(equalTo: inspectBox.contentView!.bottomAnchor, constant: -4),
         ])
+        // AX scheduler group box
+        let axLanesBox = NSBox()
+        axLanesBox.translatesAutoresizingMaskIntoConstraints = false
+        axLanesBox.title = "AX scheduler"
+        axLanesBox.contentView = NSView()
+        axLanesBox.contentView!.addSubview(axLanesField)
+        NSLayoutConstraint.activate([
+            axLanesField.topAnchor.constraint(equalTo: axLanesBox.contentView!.topAnchor, constant: 4),
+            axLanesField.leadingAnchor.constraint(equalTo: axLanesBox.contentView!.leadingAnchor, constant: 4),
+            axLanesField.trailingAnchor.constraint(equalTo: axLanesBox.contentView!.trailingAnchor, constant: -4),
+            axLanesField.bottomAnchor.constraint(equalTo: axLanesBox.contentView!.bottomAnchor, constant: -4),
+        ])
         // Log group box
         let logBox = NSBox()
         logBox.translatesAutoresizingMaskIntoConstraints = false
@@ -173,6 +193,7 @@ class DebugWindow: NSPanel {
         let container = NSView()
         container.translatesAutoresizingMaskIntoConstraints = false
         container.addSubview(inspectBox)
+        container.addSubview(axLanesBox)
         container.addSubview(logBox)
         contentView = container
         let padding: CGFloat = 12
@@ -180,7 +201,10 @@ class DebugWindow: NSPanel {
             inspectBox.topAnchor.constraint(equalTo: container.topAnchor, constant: padding),
             inspectBox.leadingAnchor.constraint(equalTo: container.leadingAnchor, constant: padding),
             inspectBox.trailingAnchor.constraint(equalTo: container.trailingAnchor, constant: -padding),
-            logBox.topAnchor.constraint(equalTo: inspectBox.bottomAnchor, constant: padding),
+            axLanesBox.topAnchor.constraint(equalTo: inspectBox.bottomAnchor, constant: padding),
+            axLanesBox.leadingAnchor.constraint(equalTo: container.leadingAnchor, constant: padding),
+            axLanesBox.trailingAnchor.constraint(equalTo: container.trailingAnchor, constant: -padding),
+            logBox.topAnchor.constraint(equalTo: axLanesBox.bottomAnchor, constant: padding),
             logBox.leadingAnchor.constraint(equalTo: container.leadingAnchor, constant: padding),
             logBox.trailingAnchor.constraint(equalTo: container.trailingAnchor, constant: -padding),
             logBox.bottomAnchor.constraint(equalTo: container.bottomAnchor, constant: -padding),
@@ -294,11 +318,18 @@ class DebugWindow: NSPanel {
 
     override func makeKeyAndOrderFront(_ sender: Any?) {
         startListening()
+        if axLanesTimer == nil {
+            axLanesTimer = Timer.scheduledTimer(withTimeInterval: 0.5, repeats: true) { [weak self] _ in
+                self?.axLanesField.stringValue = Self.formatAxLanes()
+            }
+        }
         super.makeKeyAndOrderFront(sender)
     }
 
     override func close() {
         stopInspecting()
+        axLanesTimer?.invalidate()
+        axLanesTimer = nil
         stopListening()
         clearInspectData()
         copyFeedbackTimer?.invalidate()
@@ -453,6 +484,13 @@ class DebugWindow: NSPanel {
         return field
     }
 
+    private static func formatAxLanes() -> String {
+        AXCallScheduler.shared.laneStats().map { lane in
+            let s = lane.stats
+            return "\(lane.label): queued \(s.queued) (boosted \(s.boostedQueued)) · apps \(s.flows) · peak \(s.peakQueued) · served \(s.served) · dropped \(s.dropped)"
+        }.joined(separator: "\n")
+    }
+
     private static func formatColumn(_ title: String, _ rows: [(String, String)]) -> String {
         return "\(title)\n" + rows.map { "• \($0.0): \($0.1)" }.joined(separator: "\n")
     }
@@ -1,8 +1,14 @@
 import Foundation
 
 final class Search {
+    /// The switcher scores every window against the same query, so it's indexed once per keystroke. Callers
+    /// pass the session's raw query text, never its normalized form, so every call of a keystroke hits this.
+    private static var indexedQuery = SearchTestable.indexQuery("")
+    /// The query before `indexedQuery`: what a window's `lastSearchQuery` usually narrows from
+    private static var previousIndexedQuery = SearchTestable.indexQuery("")
+
     static func normalizedQuery(_ query: String) -> String {
-        SearchTestable.normalize(query).text
+        indexed(query).normalizedText
     }
 
     static func matches(_ window: Window, query: String) -> Bool {
@@ -19,19 +25,97 @@ final class Search {
         return window.swBestSimilarity
     }
 
+    private static func indexed(_ query: String) -> SearchTestable.Indexed {
+        if indexedQuery.text != query {
+            let replaced = indexedQuery
+            indexedQuery = previousIndexedQuery.text == query ? previousIndexedQuery : SearchTestable.indexQuery(query)
+            previousIndexedQuery = replaced
+        }
+        return indexedQuery
+    }
+
+    /// A recent query, by its normalized text; nil once it's older than the last two
+    private static func recentlyIndexed(normalized: String) -> SearchTestable.Indexed? {
+        if indexedQuery.normalizedText == normalized { return indexedQuery }
+        if previousIndexedQuery.normalizedText == normalized { return previousIndexedQuery }
+        return nil
+    }
+
+    /// The window's rank after its first tier band (T1–4), for `WindowOrderResolver.searchRankedPrefix`.
+    /// `ceiling` is the best relevance its remaining bands could reach, or nil once its rank is final.
+    static func stagedRank(for window: Window, query: String) -> (relevance: Double, ceiling: Double?) {
+        stage(window, query: query, advance: false)
+    }
+
+    /// Runs the window's next tier band (T5, then T6)
+    static func advanceRank(for window: Window, query: String) -> (relevance: Double, ceiling: Double?) {
+        stage(window, query: query, advance: true)
+    }
+
+    private static func stage(_ window: Window, query originalQuery: String, advance: Bool) -> (relevance: Double, ceiling: Double?) {
+        let normalized = normalizedQuery(originalQuery)
+        if normalized.isEmpty { return (0, nil) }
+        let cacheKey = normalized + "|3"
+        if isCached(window, cacheKey: cacheKey, query: indexed(originalQuery)) { return (window.swBestSimilarity, nil) }
+        var staged = window.swStaged?.key == cacheKey ? window.swStaged!.match : SearchTestable.StagedMatch()
+        if advance || staged.throughTier == 0 {
+            staged.advance(query: indexed(originalQuery), appName: appNameIndex(window), title: titleIndex(window))
+        }
+        if staged.isComplete {
+            commit(staged, to: window, cacheKey: cacheKey)
+            return (window.swBestSimilarity, nil)
+        }
+        window.swStaged = (cacheKey, staged)
+        return (staged.relevance, staged.ceiling)
+    }
+
     private static func ensureCache(for window: Window, normalizedQuery normalized: String, originalQuery: String) {
         let cacheKey = normalized + "|3"
-        if window.lastSearchQuery == cacheKey { return }
-        let appName = window.application.localizedName ?? ""
-        let title = window.title
-        let appResult = SearchTestable.tierMatch(query: originalQuery, text: appName)
-        let titleResult = SearchTestable.tierMatch(query: originalQuery, text: title)
-        window.swAppResults = appResult.map { [$0.toSWResult()] } ?? []
-        window.swTitleResults = titleResult.map { [$0.toSWResult()] } ?? []
-        let appScore = Double(appResult?.score ?? 0)
-        let titleScore = Double(titleResult?.score ?? 0)
-        window.swBestSimilarity = max(appScore * 1.02, titleScore)
+        let query = indexed(originalQuery)
+        if isCached(window, cacheKey: cacheKey, query: query) { return }
+        var staged = window.swStaged?.key == cacheKey ? window.swStaged!.match : SearchTestable.StagedMatch()
+        let appName = appNameIndex(window)
+        let title = titleIndex(window)
+        while !staged.isComplete {
+            staged.advance(query: query, appName: appName, title: title)
+        }
+        commit(staged, to: window, cacheKey: cacheKey)
+    }
+
+    private static func isCached(_ window: Window, cacheKey: String, query: SearchTestable.Indexed) -> Bool {
+        if window.lastSearchQuery == cacheKey { return true }
+        // typing one more char: a window that missed the shorter query keeps missing; skip rescoring it
+        if let previousKey = window.lastSearchQuery, window.swBestSimilarity == 0,
+           let previousQuery = recentlyIndexed(normalized: String(previousKey.dropLast(2))),
+           SearchTestable.extendedQueryStillMisses(previousQuery: previousQuery, query: query) {
+            window.lastSearchQuery = cacheKey
+            return true
+        }
+        return false
+    }
+
+    private static func commit(_ staged: SearchTestable.StagedMatch, to window: Window, cacheKey: String) {
+        window.swAppResults = staged.app.map { [$0.toSWResult()] } ?? []
+        window.swTitleResults = staged.title.map { [$0.toSWResult()] } ?? []
+        window.swBestSimilarity = staged.relevance
         window.lastSearchQuery = cacheKey
     }
-}
 
+    /// Rebuilt only when the title changed since it was last indexed
+    private static func titleIndex(_ window: Window) -> SearchTestable.Indexed {
+        let title = window.title
+        if let index = window.titleSearchIndex, index.text == title { return index }
+        let index = SearchTestable.index(title)
+        window.titleSearchIndex = index
+        return index
+    }
+
+    /// Rebuilt only when the app name changed since it was last indexed
+    private static func appNameIndex(_ window: Window) -> SearchTestable.Indexed {
+        let appName = window.application.localizedName ?? ""
+        if let index = window.appNameSearchIndex, index.text == appName { return index }
+        let index = SearchTestable.index(appName)
+        window.appNameSearchIndex = index
+        return index
+    }
+}
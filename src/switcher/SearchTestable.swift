@@ -69,31 +69,197 @@ class SearchTestable {
         return Normalized(text: String(chars), chars: chars, toOriginal: toOriginal, isWordStart: isWordStart, isHardWordStart: isHardWordStart)
     }
 
+    /// `normalize` output laid out flat for repeated scoring: each folded char is a `UInt32` code (equal
+    /// codes ⇔ equal `Character`s), word-start flags are bitsets, and the word spans are precomputed. A
+    /// window's title and app name are indexed once and reused across keystrokes (see `Search`), so a
+    /// query only pays for the match itself.
+    struct Indexed {
+        let text: String
+        let normalizedText: String
+        let original: [Character]
+        let codes: [UInt32]
+        let toOriginal: [Int]
+        let wordStarts: BitSet      // includes camelCase splits (used by T3 / T5)
+        let hardWordStarts: BitSet  // only non-alphanum boundaries, no camelCase (used by T6)
+        let alphaNums: BitSet
+        let words: [Range<Int>]
+        let wholeWords: [Range<Int>]
+        let hasUpper: Bool
+        let fuzzyPattern: FuzzyPattern?  // queries only (`indexQuery`), nil past 64 codes; T6 then falls back to `damerauLevenshtein`
+
+        var count: Int { codes.count }
+    }
+
+    /// Per-code match masks for the T6 bit-vector kernel: bit `i` of `matchMask(c)` is set iff `codes[i] == c`.
+    /// A query rarely has more than a dozen distinct chars, so a linear scan beats hashing.
+    struct FuzzyPattern {
+        let length: Int
+        private let codes: [UInt32]
+        private let masks: [UInt64]
+
+        init?(_ pattern: [UInt32]) {
+            guard !pattern.isEmpty && pattern.count <= 64 else { return nil }
+            var codes: [UInt32] = []
+            var masks: [UInt64] = []
+            for (i, c) in pattern.enumerated() {
+                if let j = codes.firstIndex(of: c) {
+                    masks[j] |= 1 << UInt64(i)
+                } else {
+                    codes.append(c)
+                    masks.append(1 << UInt64(i))
+                }
+            }
+            length = pattern.count
+            self.codes = codes
+            self.masks = masks
+        }
+
+        func matchMask(_ c: UInt32) -> UInt64 {
+            for i in 0..<codes.count where codes[i] == c { return masks[i] }
+            return 0
+        }
+    }
+
+    struct BitSet {
+        private var storage: [UInt64]
+
+        init(count: Int) {
+            storage = Array(repeating: 0, count: (count + 63) / 64)
+        }
+
+        init(_ flags: [Bool]) {
+            self.init(count: flags.count)
+            for (i, flag) in flags.enumerated() where flag { self[i] = true }
+        }
+
+        subscript(_ i: Int) -> Bool {
+            get { storage[i >> 6] & (1 << UInt64(i & 63)) != 0 }
+            set {
+                if newValue { storage[i >> 6] |= 1 << UInt64(i & 63) } else { storage[i >> 6] &= ~(1 << UInt64(i & 63)) }
+            }
+        }
+    }
+
+    /// A window title or app name: T6 only reads the query's `fuzzyPattern`, so texts don't build one
+    static func index(_ text: String) -> Indexed {
+        index(text, withFuzzyPattern: false)
+    }
+
+    /// A search query, with the bit-vector pattern T6 scores it with
+    static func indexQuery(_ query: String) -> Indexed {
+        index(query, withFuzzyPattern: true)
+    }
+
+    private static func index(_ text: String, withFuzzyPattern: Bool) -> Indexed {
+        let n = normalize(text)
+        let codes = n.chars.map { code(for: $0) }
+        return Indexed(text: text, normalizedText: n.text, original: Array(text), codes: codes,
+                       toOriginal: n.toOriginal, wordStarts: BitSet(n.isWordStart), hardWordStarts: BitSet(n.isHardWordStart),
+                       alphaNums: BitSet(n.chars.map { isAlphaNum($0) }), words: wordSpans(in: n), wholeWords: wholeWordSpans(in: n),
+                       hasUpper: text.contains(where: { $0.isUppercase }), fuzzyPattern: withFuzzyPattern ? FuzzyPattern(codes) : nil)
+    }
+
+    /// Multi-scalar graphemes (emoji sequences, unfoldable combining marks) get codes past the last
+    /// Unicode scalar, interned by their NFC form so canonically-equivalent graphemes share a code and distinct
+    /// ones never do. Titles are indexed from AX callbacks off the main thread, so the table is behind a lock.
+    /// It only grows with the distinct graphemes of titles seen this launch, and the code space past U+10FFFF
+    /// holds billions of them.
+    private static var multiScalarCodes = [String: UInt32]()
+    private static let multiScalarCodesLock: UnsafeMutablePointer<os_unfair_lock> = {
+        let p = UnsafeMutablePointer<os_unfair_lock>.allocate(capacity: 1)
+        p.initialize(to: os_unfair_lock())
+        return p
+    }()
+
+    static func code(for c: Character) -> UInt32 {
+        if c.unicodeScalars.count == 1, let ascii = c.asciiValue { return UInt32(ascii) }
+        let canonical = String(c).precomposedStringWithCanonicalMapping
+        if canonical.unicodeScalars.count == 1 { return canonical.unicodeScalars.first!.value }
+        os_unfair_lock_lock(multiScalarCodesLock)
+        defer { os_unfair_lock_unlock(multiScalarCodesLock) }
+        if let code = multiScalarCodes[canonical] { return code }
+        let code = 0x110000 + UInt32(multiScalarCodes.count)
+        multiScalarCodes[canonical] = code
+        return code
+    }
+
+    /// Appending to a query can only lose matches, never gain them: every tier's match on the longer
+    /// query implies a match on its prefix. So a candidate that missed `previousQuery` still misses
+    /// `query` and needn't be rescored. T6 breaks this twice — it's off below 3 chars, and its edit
+    /// budget grows from 1 to 2 at 10 chars — so narrowing is only claimed within one T6 regime. Lengths are
+    /// in codes, as `tierMatch` counts them, not in `Character`s of the normalized text: the two differ when
+    /// folding leaves combining marks.
+    static func extendedQueryStillMisses(previousQuery: Indexed, query: Indexed) -> Bool {
+        let previousLen = previousQuery.count
+        let len = query.count
+        guard len > previousLen, previousLen >= 3, query.codes.starts(with: previousQuery.codes) else { return false }
+        return (previousLen >= 10) == (len >= 10)
+    }
+
     static func tierMatch(query: String, text: String) -> MatchResult? {
-        let qNorm = normalize(query)
-        let tNorm = normalize(text)
-        if qNorm.chars.isEmpty || tNorm.chars.isEmpty { return nil }
-        let q = qNorm.chars
-        let t = tNorm.chars
+        tierMatch(query: indexQuery(query), text: index(text))
+    }
+
+    /// Highest score a match in any tier after `tier` can reach: `makeResult` caps each tier below the one above it
+    static func scoreCeiling(afterTier tier: Int) -> Int {
+        switch tier {
+        case ..<1: return 2 * tierExactBase - 1
+        case 1: return tierExactBase - 1
+        case 2: return tierPrefixBase - 1
+        case 3: return tierWordPrefixBase - 1
+        case 4: return tierSubstringBase - 1
+        case 5: return tierAcronymBase - 1
+        default: return 0
+        }
+    }
+
+    /// `combinedScore` run one tier band at a time — T1–4 (cheap, linear), then T5, then T6 — so a caller ranking
+    /// many windows can stop advancing one once its `ceiling` can't beat what it already ranked (see
+    /// `WindowOrderResolver.searchRankedPrefix`). Advancing until `isComplete` gives exactly `tierMatch`.
+    struct StagedMatch {
+        private(set) var throughTier = 0
+        private(set) var app: MatchResult?
+        private(set) var title: MatchResult?
+
+        var isComplete: Bool { throughTier >= 6 || (app != nil && title != nil) }
+        var relevance: Double { max(Double(app?.score ?? 0) * 1.02, Double(title?.score ?? 0)) }
+
+        /// Best relevance the remaining bands could still reach; nil once they can't change `relevance`
+        var ceiling: Double? {
+            if isComplete { return nil }
+            let remaining = Double(SearchTestable.scoreCeiling(afterTier: throughTier))
+            let best = max(app == nil ? remaining * 1.02 : 0, title == nil ? remaining : 0)
+            return best > relevance ? best : nil
+        }
+
+        mutating func advance(query: Indexed, appName: Indexed, title titleText: Indexed) {
+            let tiers = throughTier < 4 ? 1...4 : (throughTier + 1)...(throughTier + 1)
+            if app == nil { app = SearchTestable.tierMatch(query: query, text: appName, tiers: tiers) }
+            if title == nil { title = SearchTestable.tierMatch(query: query, text: titleText, tiers: tiers) }
+            throughTier = tiers.upperBound
+        }
+    }
+
+    static func tierMatch(query qIdx: Indexed, text tIdx: Indexed, tiers: ClosedRange<Int> = 1...6) -> MatchResult? {
+        if qIdx.count == 0 || tIdx.count == 0 { return nil }
+        let q = qIdx.codes
+        let t = tIdx.codes
         let qLen = q.count
         let tLen = t.count
-        let words = wordSpans(in: tNorm)
-        let queryHasUpper = query.contains(where: { $0.isUppercase })
+        let words = tIdx.words
 
         // Tier 1: exact
-        if qLen == tLen && q == t {
+        if tiers.contains(1) && qLen == tLen && q == t {
             return makeResult(tierBase: tierExactBase, tier: 1, normSpan: 0..<tLen,
-                              subspans: nil, qNorm: qNorm, tNorm: tNorm, query: query, text: text,
-                              queryHasUpper: queryHasUpper, words: words, edits: 0)
+                              subspans: nil, qIdx: qIdx, tIdx: tIdx, edits: 0)
         }
         // Tier 2: text prefix
-        if qLen < tLen && Array(t.prefix(qLen)) == q {
+        if tiers.contains(2) && qLen < tLen && t.starts(with: q) {
             return makeResult(tierBase: tierPrefixBase, tier: 2, normSpan: 0..<qLen,
-                              subspans: nil, qNorm: qNorm, tNorm: tNorm, query: query, text: text,
-                              queryHasUpper: queryHasUpper, words: words, edits: 0)
+                              subspans: nil, qIdx: qIdx, tIdx: tIdx, edits: 0)
         }
         // Tier 3: word prefix
-        for word in words {
+        for word in words where tiers.contains(3) {
             let wLen = word.upperBound - word.lowerBound
             if wLen < qLen { continue }
             if word.lowerBound == 0 { continue } // already tried T2
@@ -104,48 +270,53 @@ class SearchTestable {
             if match {
                 let span = word.lowerBound..<(word.lowerBound + qLen)
                 return makeResult(tierBase: tierWordPrefixBase, tier: 3, normSpan: span,
-                                  subspans: nil, qNorm: qNorm, tNorm: tNorm, query: query, text: text,
-                                  queryHasUpper: queryHasUpper, words: words, edits: 0)
+                                  subspans: nil, qIdx: qIdx, tIdx: tIdx, edits: 0)
             }
         }
         // Tier 4: contiguous substring
-        if let span = findSubarray(in: t, sub: q) {
+        if tiers.contains(4), let span = findSubarray(in: t, sub: q) {
             return makeResult(tierBase: tierSubstringBase, tier: 4, normSpan: span,
-                              subspans: nil, qNorm: qNorm, tNorm: tNorm, query: query, text: text,
-                              queryHasUpper: queryHasUpper, words: words, edits: 0)
+                              subspans: nil, qIdx: qIdx, tIdx: tIdx, edits: 0)
         }
         // Tier 5: acronym (subsequence of word starts)
-        if let acronym = matchAcronym(query: q, text: t, words: words) {
+        if tiers.contains(5), let acronym = matchAcronym(query: q, text: t, words: words) {
             return makeResult(tierBase: tierAcronymBase, tier: 5, normSpan: acronym.span,
-                              subspans: acronym.subspans, qNorm: qNorm, tNorm: tNorm, query: query, text: text,
-                              queryHasUpper: queryHasUpper, words: words, edits: 0)
+                              subspans: acronym.subspans, qIdx: qIdx, tIdx: tIdx, edits: 0)
         }
         // Tier 6: fuzzy prefix-of-word match (handles typos AND partial-prefix typing)
         // Use whole words (NOT camelCase-split) so e.g. "gthub" matches "GitHub" as one fuzzy unit.
-        if qLen >= 3 {
+        if tiers.contains(6) && qLen >= 3 {
             let maxEdits = qLen <= 9 ? 1 : 2
             var best: MatchResult? = nil
-            let fuzzyWords = wholeWordSpans(in: tNorm)
-            for word in fuzzyWords {
+            for word in tIdx.wholeWords {
                 let wLen = word.upperBound - word.lowerBound
                 let mLo = max(1, qLen - maxEdits)
                 let mHi = min(wLen, qLen + maxEdits)
                 if mLo > mHi { continue }
-                let wordChars = Array(t[word.lowerBound..<word.upperBound])
-                for m in mLo...mHi {
-                    let prefix = m == wLen ? wordChars : Array(wordChars[0..<m])
-                    guard let dist = damerauLevenshtein(q, prefix, k: maxEdits) else { continue }
+                func consider(_ m: Int, _ dist: Int) {
                     let unmatched = wLen - m
                     let partialPenalty = min(30, 5 * unmatched)
                     let baseScore = tierFuzzyBase - 25 * dist - partialPenalty
                     let span = word.lowerBound..<(word.lowerBound + m)
                     let candidate = makeResult(tierBase: baseScore, tier: 6, normSpan: span,
-                                               subspans: nil, qNorm: qNorm, tNorm: tNorm, query: query, text: text,
-                                               queryHasUpper: queryHasUpper, words: words, edits: dist)
+                                               subspans: nil, qIdx: qIdx, tIdx: tIdx, edits: dist)
                     if best == nil || candidate.score > best!.score {
                         best = candidate
                     }
                 }
+                if let pattern = qIdx.fuzzyPattern {
+                    // one pass over the word scores every prefix length
+                    prefixDistances(pattern, t, from: word.lowerBound, upTo: mHi) { m, dist in
+                        if m >= mLo && dist <= maxEdits { consider(m, dist) }
+                    }
+                } else {
+                    let wordChars = Array(t[word.lowerBound..<word.upperBound])
+                    for m in mLo...mHi {
+                        let prefix = m == wLen ? wordChars : Array(wordChars[0..<m])
+                        guard let dist = damerauLevenshtein(q, prefix, k: maxEdits) else { continue }
+                        consider(m, dist)
+                    }
+                }
             }
             if let result = best { return result }
         }
@@ -153,11 +324,8 @@ class SearchTestable {
     }
 
     private static func makeResult(tierBase: Int, tier: Int, normSpan: Range<Int>,
-                                   subspans: [Range<Int>]?, qNorm: Normalized, tNorm: Normalized,
-                                   query: String, text: String, queryHasUpper: Bool,
-                                   words: [Range<Int>], edits: Int) -> MatchResult {
-        let bonus = computeBonuses(normSpan: normSpan, tier: tier, qNorm: qNorm, tNorm: tNorm,
-                                   query: query, text: text, queryHasUpper: queryHasUpper, words: words)
+                                   subspans: [Range<Int>]?, qIdx: Indexed, tIdx: Indexed, edits: Int) -> MatchResult {
+        let bonus = computeBonuses(normSpan: normSpan, tier: tier, qIdx: qIdx, tIdx: tIdx)
         let nextTierBase: Int
         switch tier {
         case 1: nextTierBase = tierBase + 1000
@@ -170,10 +338,10 @@ class SearchTestable {
         }
         let cap = nextTierBase - 1
         let score = min(tierBase + bonus, cap)
-        let originalSpan = mapSpan(normSpan, tNorm)
+        let originalSpan = mapSpan(normSpan, tIdx)
         let originalSubspans: [Range<Int>]
         if let subs = subspans {
-            originalSubspans = subs.compactMap { mapSpan($0, tNorm) }
+            originalSubspans = subs.compactMap { mapSpan($0, tIdx) }
         } else {
             originalSubspans = originalSpan.map { [$0] } ?? []
         }
@@ -182,26 +350,23 @@ class SearchTestable {
                            subspans: originalSubspans)
     }
 
-    private static func computeBonuses(normSpan: Range<Int>, tier: Int,
-                                       qNorm: Normalized, tNorm: Normalized,
-                                       query: String, text: String, queryHasUpper: Bool,
-                                       words: [Range<Int>]) -> Int {
+    private static func computeBonuses(normSpan: Range<Int>, tier: Int, qIdx: Indexed, tIdx: Indexed) -> Int {
         var bonus = 0
         let startIdx = normSpan.lowerBound
         // Position bonus
         bonus += max(0, 60 - startIdx)
         // Word boundary at start
-        let isStartAtBoundary = startIdx == 0 || (startIdx < tNorm.isWordStart.count && tNorm.isWordStart[startIdx])
+        let isStartAtBoundary = startIdx == 0 || (startIdx < tIdx.count && tIdx.wordStarts[startIdx])
         if isStartAtBoundary { bonus += 15 }
         // Whole-word bonus (only for contiguous tiers 1-4)
         if tier >= 1 && tier <= 4 {
             let endIdx = normSpan.upperBound
             let isEndAtBoundary: Bool
-            if endIdx >= tNorm.chars.count {
+            if endIdx >= tIdx.count {
                 isEndAtBoundary = true
-            } else if !isAlphaNum(tNorm.chars[endIdx]) {
+            } else if !tIdx.alphaNums[endIdx] {
                 isEndAtBoundary = true
-            } else if tNorm.isWordStart[endIdx] {
+            } else if tIdx.wordStarts[endIdx] {
                 isEndAtBoundary = true
             } else {
                 isEndAtBoundary = false
@@ -209,39 +374,34 @@ class SearchTestable {
             if isStartAtBoundary && isEndAtBoundary { bonus += 10 }
         }
         // Length-ratio bonus
-        let qLen = qNorm.chars.count
-        let tLen = tNorm.chars.count
+        let qLen = qIdx.count
+        let tLen = tIdx.count
         if tLen > 0 {
             let ratio = Int((Double(30 * qLen) / Double(tLen)).rounded())
             bonus += min(30, max(0, ratio))
         }
         // Case-exact bonus (only when query has uppercase, only for tiers 1-5)
-        if queryHasUpper && tier >= 1 && tier <= 5 {
-            let caseExact = countCaseExactMatches(normSpan: normSpan, tier: tier,
-                                                   qNorm: qNorm, tNorm: tNorm,
-                                                   query: query, text: text, words: words)
+        if qIdx.hasUpper && tier >= 1 && tier <= 5 {
+            let caseExact = countCaseExactMatches(normSpan: normSpan, tier: tier, qIdx: qIdx, tIdx: tIdx)
             bonus += min(30, 5 * caseExact)
         }
         return bonus
     }
 
-    private static func countCaseExactMatches(normSpan: Range<Int>, tier: Int,
-                                              qNorm: Normalized, tNorm: Normalized,
-                                              query: String, text: String,
-                                              words: [Range<Int>]) -> Int {
-        let originalQuery = Array(query)
-        let originalText = Array(text)
+    private static func countCaseExactMatches(normSpan: Range<Int>, tier: Int, qIdx: Indexed, tIdx: Indexed) -> Int {
+        let originalQuery = qIdx.original
+        let originalText = tIdx.original
         var count = 0
         if tier == 5 {
             // Acronym: each subspan is one char from one word; match query[i] vs text at that position
             // For acronym, we know the matching follows word starts in order.
             var qi = 0
-            for word in words {
-                if qi >= qNorm.chars.count { break }
-                if word.lowerBound >= tNorm.chars.count { continue }
-                if tNorm.chars[word.lowerBound] == qNorm.chars[qi] {
-                    let qOrig = qNorm.toOriginal[qi]
-                    let tOrig = tNorm.toOriginal[word.lowerBound]
+            for word in tIdx.words {
+                if qi >= qIdx.count { break }
+                if word.lowerBound >= tIdx.count { continue }
+                if tIdx.codes[word.lowerBound] == qIdx.codes[qi] {
+                    let qOrig = qIdx.toOriginal[qi]
+                    let tOrig = tIdx.toOriginal[word.lowerBound]
                     if qOrig < originalQuery.count && tOrig < originalText.count
                         && originalQuery[qOrig] == originalText[tOrig] {
                         count += 1
@@ -253,13 +413,13 @@ class SearchTestable {
         }
         // Tiers 1-4: contiguous, qLen == normSpan.count
         var seenQOrig = Set<Int>()
-        let qLen = qNorm.chars.count
+        let qLen = qIdx.count
         for k in 0..<qLen {
             let nIdx = normSpan.lowerBound + k
-            if nIdx >= tNorm.toOriginal.count { break }
-            if k >= qNorm.toOriginal.count { break }
-            let qOrig = qNorm.toOriginal[k]
-            let tOrig = tNorm.toOriginal[nIdx]
+            if nIdx >= tIdx.toOriginal.count { break }
+            if k >= qIdx.toOriginal.count { break }
+            let qOrig = qIdx.toOriginal[k]
+            let tOrig = tIdx.toOriginal[nIdx]
             if seenQOrig.contains(qOrig) { continue }
             seenQOrig.insert(qOrig)
             if qOrig < originalQuery.count && tOrig < originalText.count
@@ -306,7 +466,7 @@ class SearchTestable {
         return spans
     }
 
-    private static func matchAcronym(query: [Character], text: [Character], words: [Range<Int>]) -> (span: Range<Int>, subspans: [Range<Int>])? {
+    private static func matchAcronym(query: [UInt32], text: [UInt32], words: [Range<Int>]) -> (span: Range<Int>, subspans: [Range<Int>])? {
         if query.isEmpty || words.isEmpty { return nil }
         var qi = 0
         var matches: [Int] = []
@@ -325,7 +485,37 @@ class SearchTestable {
         return (firstStart..<lastEnd, subspans)
     }
 
-    static func damerauLevenshtein(_ a: [Character], _ b: [Character], k: Int) -> Int? {
+    /// Bit-parallel optimal-string-alignment distance (Hyyrö 2003) between the pattern and each prefix
+    /// `text[start..<start + m]`, for m in `1...maxLength`: calls `body(m, distance)` once per text char.
+    /// Same values as `damerauLevenshtein` with an unbounded `k`, in O(maxLength) word ops and no allocation.
+    static func prefixDistances(_ pattern: FuzzyPattern, _ text: [UInt32], from start: Int, upTo maxLength: Int,
+                                _ body: (_ m: Int, _ distance: Int) -> Void) {
+        var vp = UInt64.max
+        var vn: UInt64 = 0
+        var d0: UInt64 = 0
+        var previousEq: UInt64 = 0
+        var distance = pattern.length
+        let last: UInt64 = 1 << UInt64(pattern.length - 1)
+        var m = 0
+        while m < maxLength {
+            let eq = pattern.matchMask(text[start + m])
+            let transposition = ((~d0 & eq) << 1) & previousEq
+            d0 = (((eq & vp) &+ vp) ^ vp) | eq | vn | transposition
+            var hp = vn | ~(d0 | vp)
+            var hn = d0 & vp
+            if hp & last != 0 { distance += 1 }
+            if hn & last != 0 { distance -= 1 }
+            hp = (hp << 1) | 1
+            hn = hn << 1
+            vp = hn | ~(d0 | hp)
+            vn = hp & d0
+            previousEq = eq
+            m += 1
+            body(m, distance)
+        }
+    }
+
+    static func damerauLevenshtein<T: Equatable>(_ a: [T], _ b: [T], k: Int) -> Int? {
         let n = a.count, m = b.count
         if abs(n - m) > k { return nil }
         let inf = Int.max / 2
@@ -354,7 +544,7 @@ class SearchTestable {
         return result <= k ? result : nil
     }
 
-    private static func findSubarray(in haystack: [Character], sub: [Character]) -> Range<Int>? {
+    private static func findSubarray(in haystack: [UInt32], sub: [UInt32]) -> Range<Int>? {
         let n = haystack.count, m = sub.count
         if m == 0 || n < m { return nil }
         for i in 0...(n - m) {
@@ -367,11 +557,11 @@ class SearchTestable {
         return nil
     }
 
-    private static func mapSpan(_ normSpan: Range<Int>, _ tNorm: Normalized) -> Range<Int>? {
+    private static func mapSpan(_ normSpan: Range<Int>, _ tIdx: Indexed) -> Range<Int>? {
         if normSpan.isEmpty { return nil }
-        guard normSpan.lowerBound >= 0, normSpan.upperBound <= tNorm.toOriginal.count else { return nil }
-        let start = tNorm.toOriginal[normSpan.lowerBound]
-        let end = tNorm.toOriginal[normSpan.upperBound - 1] + 1
+        guard normSpan.lowerBound >= 0, normSpan.upperBound <= tIdx.toOriginal.count else { return nil }
+        let start = tIdx.toOriginal[normSpan.lowerBound]
+        let end = tIdx.toOriginal[normSpan.upperBound - 1] + 1
         return start..<end
     }
 
@@ -496,6 +496,266 @@ final class SearchTests: XCTestCase {
         XCTAssertNil(SearchTestable.damerauLevenshtein(Array("abcd"), Array("efgh"), k: 1))
     }
 
+    // MARK: - Indexed text
+
+    func testIndexedTextIsReusableAcrossQueries() throws {
+        let title = SearchTestable.index("🎉 Project · GitHub")
+        XCTAssertEqual(SearchTestable.tierMatch(query: SearchTestable.indexQuery("github"), text: title)?.tier, 4)
+        XCTAssertEqual(SearchTestable.tierMatch(query: SearchTestable.indexQuery("pg"), text: title)?.tier, 5)
+        XCTAssertEqual(SearchTestable.tierMatch(query: SearchTestable.indexQuery("project"), text: title)?.tier, 3)
+    }
+
+    func testIndexedCodesFollowCharacterEquality() throws {
+        XCTAssertEqual(SearchTestable.code(for: "\u{00C5}"), SearchTestable.code(for: "A\u{030A}")) // Å precomposed vs combining
+        XCTAssertEqual(SearchTestable.code(for: "🇯🇵"), SearchTestable.code(for: "🇯🇵"))
+        XCTAssertNotEqual(SearchTestable.code(for: "🇯🇵"), SearchTestable.code(for: "🇫🇷"))
+    }
+
+    func testManyDistinctGraphemesNeverShareACode() throws {
+        // CJK ideographs in an enclosing circle: no precomposed form, so each one is interned
+        let graphemes = (0x4E00..<0x4E00 + 6_000).map { Character("\(Character(UnicodeScalar($0)!))\u{20DD}") }
+        let codes = graphemes.map { SearchTestable.code(for: $0) }
+        XCTAssertEqual(Set(codes).count, graphemes.count)
+        XCTAssertEqual(codes.last, SearchTestable.code(for: graphemes.last!))
+    }
+
+    // MARK: - Incremental narrowing
+
+    func testExtendedQueryStillMissesWithinT6Regime() throws {
+        XCTAssertTrue(stillMisses("kyo", "kyot"))
+        XCTAssertTrue(stillMisses("shinkansen", "shinkansens"))
+        XCTAssertFalse(stillMisses("ky", "kyo"))       // T6 turns on at 3
+        XCTAssertFalse(stillMisses("shinkanse", "shinkansen")) // 2 edits at 10
+        XCTAssertFalse(stillMisses("kyo", "tok"))      // not an extension
+        XCTAssertFalse(stillMisses("kyoto", "kyo"))    // backspace
+    }
+
+    func testExtendedQueryNeverGainsMatches() throws {
+        var rng = SeededGenerator(seed: 42)
+        let alphabet = Array("abcdeko ")
+        for _ in 0..<2000 {
+            let text = String((0..<Int.random(in: 3...24, using: &rng)).map { _ in alphabet.randomElement(using: &rng)! })
+            let query = String((0..<Int.random(in: 3...12, using: &rng)).map { _ in alphabet.randomElement(using: &rng)! })
+                .replacingOccurrences(of: " ", with: "")
+            for cut in 3..<max(3, query.count) {
+                let shorter = String(query.prefix(cut))
+                guard stillMisses(shorter, query) else { continue }
+                if match(shorter, text) == nil {
+                    XCTAssertNil(match(query, text), "\(query) matched \(text) but \(shorter) did not")
+                }
+            }
+        }
+    }
+
+    func testExtendedQueryCountsCodesNotCharacters() throws {
+        // dropping the spaces joins the regional indicators into one `Character` of the normalized text, but they
+        // stay one code each, as `tierMatch` counts them
+        XCTAssertEqual(SearchTestable.indexQuery("abcdefg🇯 🇵 🇫").count, 10)
+        XCTAssertFalse(stillMisses("abcdefg🇯", "abcdefg🇯 🇵 🇫"), "10 codes: T6 allows 2 edits")
+        XCTAssertTrue(stillMisses("abc🇯", "abc🇯 🇵"))
+    }
+
+    private func stillMisses(_ previousQuery: String, _ query: String) -> Bool {
+        SearchTestable.extendedQueryStillMisses(previousQuery: SearchTestable.indexQuery(previousQuery), query: SearchTestable.indexQuery(query))
+    }
+
+    // MARK: - Benchmark: keystroke-to-ranked-list latency
+
+    func testBenchmarkKeystrokeToRankedList1k() throws {
+        let windows = syntheticWindows(1_000)
+        measure { rankPerKeystroke(windows, ["s", "sh", "shi", "shin", "shink", "shinka", "shinkan"]) }
+    }
+
+    func testBenchmarkKeystrokeToRankedList10k() throws {
+        let windows = syntheticWindows(10_000)
+        measure { rankPerKeystroke(windows, ["s", "sh", "shi", "shin", "shink", "shinka", "shinkan"]) }
+    }
+
+    private typealias RankedWindow = (appName: SearchTestable.Indexed, title: SearchTestable.Indexed, state: WindowState, app: ApplicationState)
+
+    /// Mirrors what `Windows.sort` runs per keystroke while searching: `Search.stagedRank` for every window
+    /// (a window that missed the shorter query still misses, as `Search.isCached` decides), then
+    /// `WindowOrderResolver.searchRankedPrefix` over the first screenful, advancing ranks on demand like
+    /// `Search.advanceRank`. Each keystroke starts from the previous one's per-window results.
+    private func rankPerKeystroke(_ windows: [RankedWindow], _ keystrokes: [String]) {
+        var lastQuery = [SearchTestable.Indexed?](repeating: nil, count: windows.count)
+        var lastRelevance = [Double](repeating: 0, count: windows.count)
+        for keystroke in keystrokes {
+            let query = SearchTestable.indexQuery(keystroke)
+            var staged = [SearchTestable.StagedMatch](repeating: SearchTestable.StagedMatch(), count: windows.count)
+            var ceilings = [Double?]()
+            ceilings.reserveCapacity(windows.count)
+            let facts = windows.indices.map { i -> OrderWindow in
+                if let previous = lastQuery[i], lastRelevance[i] == 0,
+                   SearchTestable.extendedQueryStillMisses(previousQuery: previous, query: query) {
+                    ceilings.append(nil)
+                } else {
+                    staged[i].advance(query: query, appName: windows[i].appName, title: windows[i].title)
+                    ceilings.append(staged[i].ceiling)
+                }
+                return OrderWindow(state: windows[i].state, app: windows[i].app,
+                                   searchMatches: staged[i].relevance > 0, searchRelevance: staged[i].relevance)
+            }
+            _ = WindowOrderResolver.searchRankedPrefix(facts, ceilings: ceilings, limit: 64) { i in
+                staged[i].advance(query: query, appName: windows[i].appName, title: windows[i].title)
+                return (staged[i].relevance, staged[i].ceiling)
+            }
+            // the next keystroke narrows only from windows whose rank is final; the others are scored again
+            for i in windows.indices {
+                let isFinal = ceilings[i] == nil || staged[i].isComplete
+                lastQuery[i] = isFinal ? query : nil
+                lastRelevance[i] = staged[i].relevance
+            }
+        }
+    }
+
+    private func syntheticWindows(_ count: Int) -> [RankedWindow] {
+        let apps = ["Safari", "Google Chrome", "Xcode", "Slack", "Terminal", "Finder", "Zoom", "Notes"]
+        return syntheticTitles(count).enumerated().map { i, title in
+            let appName = apps[i % apps.count]
+            let state = WindowState(id: "\(i)", isPhantom: false, isWindowlessApp: false, isFullscreen: false,
+                                    isMinimized: false, isTabbed: false, isOnAllSpaces: false, spaceIds: [],
+                                    spaceIndexes: [], lastFocusOrder: i, creationOrder: i, title: title)
+            let app = ApplicationState(pid: 0, bundleIdentifier: nil, localizedName: appName, isHidden: false)
+            return (SearchTestable.index(appName), SearchTestable.index(title), state, app)
+        }
+    }
+
+    private func syntheticTitles(_ count: Int) -> [String] {
+        var rng = SeededGenerator(seed: 7)
+        let words = ["Tokyo", "Shinkansen", "Schedule", "GitHub", "Pull", "Request", "Chrome", "DevTools", "README.md",
+                     "src/switcher/Search.swift", "Kyoto", "Airbnb", "général", "Café", "Wikipedia", "Slack", "Inbox",
+                     "Xcode", "Build", "Succeeded", "Figma", "Design", "System", "🎉", "Zoom", "Meeting", "Notes", "2024"]
+        return (0..<count).map { _ in
+            (0..<Int.random(in: 2...10, using: &rng)).map { _ in words.randomElement(using: &rng)! }.joined(separator: " - ")
+        }
+    }
+
+    // MARK: - Bit-parallel T6 kernel
+
+    func testPrefixDistancesMatchDamerauLevenshtein() throws {
+        var rng = SeededGenerator(seed: 1)
+        let alphabet: [UInt32] = [97, 98, 99, 100, 101]
+        for _ in 0..<5000 {
+            let qLen = Int.random(in: 1...(Bool.random(using: &rng) ? 12 : 64), using: &rng)
+            let q = (0..<qLen).map { _ in alphabet[Int.random(in: 0..<4, using: &rng)] }
+            let word = (0..<Int.random(in: 1...20, using: &rng)).map { _ in alphabet.randomElement(using: &rng)! }
+            var seen = 0
+            SearchTestable.prefixDistances(SearchTestable.FuzzyPattern(q)!, word, from: 0, upTo: word.count) { m, distance in
+                seen += 1
+                for k in 1...2 {
+                    let expected = SearchTestable.damerauLevenshtein(q, Array(word[0..<m]), k: k)
+                    XCTAssertEqual(distance <= k ? distance : nil, expected, "\(q) vs \(word[0..<m]) at k=\(k)")
+                }
+            }
+            XCTAssertEqual(seen, word.count)
+        }
+    }
+
+    func testT6KernelScoresAndSpansMatchDPFallback() throws {
+        var rng = SeededGenerator(seed: 2)
+        let words = ["tokyo", "Kyoto", "shinkansen", "GitHub", "development", "chrome", "général", "Café", "knwon"]
+        for _ in 0..<2000 {
+            let text = (0..<Int.random(in: 1...5, using: &rng)).map { _ in words.randomElement(using: &rng)! }.joined(separator: " ")
+            var query = Array(words.randomElement(using: &rng)!.lowercased())
+            for _ in 0..<Int.random(in: 0...2, using: &rng) where query.count > 1 {
+                let i = Int.random(in: 0..<(query.count - 1), using: &rng)
+                switch Int.random(in: 0..<3, using: &rng) {
+                    case 0: query.swapAt(i, i + 1)
+                    case 1: query.remove(at: i)
+                    default: query[i] = "x"
+                }
+            }
+            let q = SearchTestable.indexQuery(String(query.prefix(Int.random(in: 1...query.count, using: &rng))))
+            let t = SearchTestable.index(text)
+            let kernel = SearchTestable.tierMatch(query: q, text: t)
+            let dp = SearchTestable.tierMatch(query: withoutFuzzyPattern(q), text: t)
+            XCTAssertEqual(kernel?.tier, dp?.tier, "\(q.text) vs \(text)")
+            XCTAssertEqual(kernel?.score, dp?.score, "\(q.text) vs \(text)")
+            XCTAssertEqual(kernel?.span, dp?.span, "\(q.text) vs \(text)")
+        }
+    }
+
+    func testQueriesPast64CharsFallBackToDP() throws {
+        let long = String(repeating: "a", count: 65)
+        XCTAssertNil(SearchTestable.indexQuery(long).fuzzyPattern)
+        XCTAssertNotNil(SearchTestable.indexQuery(String(long.dropLast())).fuzzyPattern)
+        XCTAssertEqual(tier(long + "b", long + "c"), 6)
+    }
+
+    func testOnlyQueriesBuildAFuzzyPattern() throws {
+        XCTAssertNil(SearchTestable.index("GitHub - Pull Request").fuzzyPattern)
+        XCTAssertNotNil(SearchTestable.indexQuery("gthub").fuzzyPattern)
+    }
+
+    private func withoutFuzzyPattern(_ i: SearchTestable.Indexed) -> SearchTestable.Indexed {
+        SearchTestable.Indexed(text: i.text, normalizedText: i.normalizedText, original: i.original, codes: i.codes,
+                               toOriginal: i.toOriginal, wordStarts: i.wordStarts, hardWordStarts: i.hardWordStarts,
+                               alphaNums: i.alphaNums, words: i.words, wholeWords: i.wholeWords, hasUpper: i.hasUpper,
+                               fuzzyPattern: nil)
+    }
+
+    // MARK: - Staged tier bands
+
+    func testStagedMatchCompletesToTierMatch() throws {
+        var rng = SeededGenerator(seed: 3)
+        let apps = ["Safari", "Google Chrome", "Xcode", "Slack", "Terminal", "Café"]
+        let words = ["tokyo", "Kyoto", "shinkansen", "GitHub", "Pull", "Request", "général", "DevTools", "knwon"]
+        for _ in 0..<2000 {
+            let app = apps.randomElement(using: &rng)!
+            let title = (0..<Int.random(in: 1...5, using: &rng)).map { _ in words.randomElement(using: &rng)! }.joined(separator: " ")
+            var query = Array(Bool.random(using: &rng) ? app : words.randomElement(using: &rng)!)
+            if query.count > 3 && Bool.random(using: &rng) { query.swapAt(1, 2) }
+            let q = SearchTestable.indexQuery(String(query.prefix(Int.random(in: 1...query.count, using: &rng))))
+            var staged = SearchTestable.StagedMatch()
+            while !staged.isComplete {
+                staged.advance(query: q, appName: SearchTestable.index(app), title: SearchTestable.index(title))
+            }
+            let appResult = SearchTestable.tierMatch(query: q, text: SearchTestable.index(app))
+            let titleResult = SearchTestable.tierMatch(query: q, text: SearchTestable.index(title))
+            XCTAssertEqual(staged.app?.score, appResult?.score, "\(q.text) vs \(app)")
+            XCTAssertEqual(staged.title?.score, titleResult?.score, "\(q.text) vs \(title)")
+            XCTAssertEqual(staged.title?.span, titleResult?.span, "\(q.text) vs \(title)")
+            XCTAssertEqual(staged.relevance, SearchTestable.combinedScore(query: q.text, appName: app, title: title))
+        }
+    }
+
+    func testStagedCeilingBoundsTheFinalRelevance() throws {
+        let q = SearchTestable.indexQuery("gthub")
+        let app = SearchTestable.index("Safari")
+        let title = SearchTestable.index("GitHub - Pull Request")
+        var staged = SearchTestable.StagedMatch()
+        staged.advance(query: q, appName: app, title: title)
+        XCTAssertEqual(staged.throughTier, 4)
+        XCTAssertEqual(staged.relevance, 0)
+        XCTAssertEqual(staged.ceiling, Double(SearchTestable.tierSubstringBase - 1) * 1.02)
+        var ceiling = staged.ceiling!
+        while !staged.isComplete {
+            staged.advance(query: q, appName: app, title: title)
+            XCTAssertLessThanOrEqual(staged.relevance, ceiling)
+            ceiling = staged.ceiling ?? staged.relevance
+        }
+        XCTAssertEqual(staged.title?.tier, 6)
+        XCTAssertEqual(staged.title?.score, match("gthub", "GitHub - Pull Request")?.score)
+    }
+
+    func testStagedCeilingIsNilOnceTheRankCantChange() throws {
+        // the app's T2 score beats anything the title's T5/T6 bands could add, so the rank is final
+        var staged = SearchTestable.StagedMatch()
+        staged.advance(query: SearchTestable.indexQuery("saf"), appName: SearchTestable.index("Safari"),
+                       title: SearchTestable.index("Kyoto"))
+        XCTAssertFalse(staged.isComplete)
+        XCTAssertNil(staged.ceiling)
+    }
+
+    func testScoreCeilingCapsEveryLaterTier() throws {
+        XCTAssertEqual(SearchTestable.scoreCeiling(afterTier: 4), 399)
+        XCTAssertEqual(SearchTestable.scoreCeiling(afterTier: 5), 199)
+        XCTAssertEqual(SearchTestable.scoreCeiling(afterTier: 6), 0)
+        XCTAssertLessThanOrEqual(score("tbwr", "The Browser Wars Revisited"), SearchTestable.scoreCeiling(afterTier: 4))
+        XCTAssertLessThanOrEqual(score("shinkanzen", "shinkansen"), SearchTestable.scoreCeiling(afterTier: 5))
+    }
+
     // MARK: - MatchResult → SWResult bridging
 
     /// `toSWResult` is called by `Search.swift` to hand match data to the rendering layer. It
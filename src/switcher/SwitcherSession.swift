@@ -21,4 +21,6 @@ final class SwitcherSession {
     var hoveredIndex: Int?
     var selectedTarget: String?
     var searchQuery: String = ""
+    /// The current query's hidden search tail was revealed (`Windows.rankTail`); later sorts for it rank every window
+    var searchTailRevealed: Bool = false
 }
@@ -0,0 +1,154 @@
+import Cocoa
+
+/// Row packing for the switcher's tiles, over flat arrays of tile ids and widths. Extracted from
+/// `TilesView.layoutTileViews` / `dryRunLayoutTileViews` so the math is unit-testable and benchmarkable
+/// without `TileView`s (same idea as `DragAndDropResolver`). `TilesView` measures the tiles, hands the widths
+/// here, and applies the resulting origins and rows to the views.
+///
+/// The layout is cached: `update` diffs the new widths against the last ones and recomputes from the row of
+/// the first changed tile onward, stopping as soon as a row starts on the same tile as before past the last
+/// change (every row after it would come out identical). When one window's title changed, the packing costs
+/// one or two rows of math; `TilesView` still measures and places every tile.
+struct TileLayout {
+    struct Metrics: Equatable {
+        var widthMax: CGFloat
+        var tileHeight: CGFloat
+        /// `Appearance.interCellPadding`: around the grid and between tiles
+        var padding: CGFloat
+        var isLeftToRight: Bool
+    }
+
+    /// Which tile sits in which row. `TilesView` re-applies per-row view state (first/last in row, views in
+    /// row) only when this changes.
+    struct RowSignature: Equatable {
+        var ids = [Int]()
+        /// index (into `ids`) of each row's first tile. Row 0 can be empty when the first tile is wider than
+        /// `widthMax`: it then starts row 1, as it always did.
+        var rowStarts = [Int]()
+    }
+
+    private(set) var metrics: Metrics?
+    private(set) var widths = [CGFloat]()
+    /// tile origins in the document view, before `TilesView.centerRows` and the right-to-left crop
+    private(set) var origins = [CGPoint]()
+    private(set) var rowOfTile = [Int]()
+    private(set) var signature = RowSignature()
+    private(set) var maxX = CGFloat(0)
+    private(set) var maxY = CGFloat(0)
+    /// how many tiles the last `update` re-placed (0 when nothing changed)
+    private(set) var lastRecomputedCount = 0
+    private var rowYs = [CGFloat]()
+    /// per row, how far its tiles reach (in reading direction); only tiles that didn't open the row count,
+    /// as in the original loop
+    private var rowExtents = [CGFloat]()
+
+    var ids: [Int] { signature.ids }
+    var rowCount: Int { signature.rowStarts.count }
+
+    /// Lay out `widths` (one per displayed tile, `ids` identifying them), reusing the cached rows before the
+    /// first change. A metrics change relays everything out.
+    mutating func update(ids newIds: [Int], widths newWidths: [CGFloat], metrics newMetrics: Metrics) {
+        precondition(newIds.count == newWidths.count)
+        let oldCount = widths.count
+        let newCount = newWidths.count
+        var firstChanged = 0
+        var lastChanged = newCount - 1
+        if newMetrics == metrics && oldCount > 0 {
+            let common = min(oldCount, newCount)
+            firstChanged = (0..<common).first { signature.ids[$0] != newIds[$0] || widths[$0] != newWidths[$0] } ?? common
+            if oldCount == newCount {
+                guard firstChanged < common else { lastRecomputedCount = 0; return }
+                lastChanged = (firstChanged..<common).last { signature.ids[$0] != newIds[$0] || widths[$0] != newWidths[$0] }!
+            }
+        }
+        let startRow = firstChanged == 0 ? 0 : restartRow(firstChanged)
+        metrics = newMetrics
+        signature.ids = newIds
+        widths = newWidths
+        relayout(fromRow: startRow, lastChanged: oldCount == newCount ? lastChanged : newCount - 1)
+    }
+
+    /// the first row whose packing can change when tile `index` (or the tail from it) changes. A tile opening
+    /// a row may now fit at the end of the previous one, so that row is recomputed too.
+    private func restartRow(_ index: Int) -> Int {
+        guard index < rowOfTile.count else { return max(0, rowCount - 1) }
+        let row = rowOfTile[index]
+        let start = signature.rowStarts[row]
+        if start == 0 { return 0 }
+        return start == index ? row - 1 : row
+    }
+
+    private mutating func relayout(fromRow startRow: Int, lastChanged: Int) {
+        let m = metrics!
+        let count = widths.count
+        let startingX = m.isLeftToRight ? m.padding : m.widthMax - m.padding
+        let oldRowCount = rowCount
+        var row = startRow
+        var currentX = startingX
+        var index: Int
+        if startRow == 0 {
+            index = 0
+            Self.put(&signature.rowStarts, 0, 0)
+            Self.put(&rowYs, 0, m.padding)
+            Self.put(&rowExtents, 0, 0)
+        } else {
+            // the row's first tile still opens it: nothing before it changed
+            index = signature.rowStarts[startRow]
+            row = startRow - 1
+        }
+        let firstIndex = index
+        var cutOff = false
+        while index < count {
+            let width = widths[index]
+            let projectedX = projected(currentX, width, m)
+            if (index == firstIndex && startRow > 0) || overflows(projectedX, m) {
+                row += 1
+                // past the last change, a row opening on the same tile as before packs like before, and so
+                // does everything after it
+                if index > lastChanged && row < oldRowCount && signature.rowStarts[row] == index {
+                    cutOff = true
+                    break
+                }
+                let y = (rowYs[row - 1] + m.tileHeight + m.padding).rounded(.down)
+                Self.put(&signature.rowStarts, row, index)
+                Self.put(&rowYs, row, y)
+                Self.put(&rowExtents, row, 0)
+                Self.put(&origins, index, CGPoint(x: originX(startingX, width, m), y: y))
+                currentX = projected(startingX, width, m)
+            } else {
+                Self.put(&origins, index, CGPoint(x: originX(currentX, width, m), y: rowYs[row]))
+                currentX = projectedX
+                rowExtents[row] = max(rowExtents[row], m.isLeftToRight ? currentX : m.widthMax - currentX)
+            }
+            Self.put(&rowOfTile, index, row)
+            index += 1
+        }
+        lastRecomputedCount = index - firstIndex
+        if !cutOff {
+            origins.removeSubrange(count...)
+            rowOfTile.removeSubrange(count...)
+            signature.rowStarts.removeSubrange((row + 1)...)
+            rowYs.removeSubrange((row + 1)...)
+            rowExtents.removeSubrange((row + 1)...)
+        }
+        maxX = rowExtents.max() ?? 0
+        maxY = max(m.padding + m.tileHeight + m.padding, rowYs.last! + m.tileHeight + m.padding)
+    }
+
+    private func projected(_ currentX: CGFloat, _ width: CGFloat, _ m: Metrics) -> CGFloat {
+        (m.isLeftToRight ? currentX + width + m.padding : currentX - width - m.padding).rounded(.down)
+    }
+
+    private func overflows(_ projectedX: CGFloat, _ m: Metrics) -> Bool {
+        m.isLeftToRight ? projectedX > m.widthMax : projectedX < 0
+    }
+
+    private func originX(_ currentX: CGFloat, _ width: CGFloat, _ m: Metrics) -> CGFloat {
+        m.isLeftToRight ? currentX : currentX - width
+    }
+
+    /// overwrite in place, or append right at the end: arrays are rewritten front to back from the restart
+    private static func put<T>(_ array: inout [T], _ index: Int, _ value: T) {
+        if index < array.count { array[index] = value } else { array.append(value) }
+    }
+}
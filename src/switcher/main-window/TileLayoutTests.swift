@@ -0,0 +1,204 @@
+import XCTest
+import CoreGraphics
+
+/// Pins the switcher's row packing (what `TilesView.layoutTileViews` used to compute inline) and the
+/// incremental relayout: after any change, the cached layout must equal a layout computed from scratch, while
+/// only re-placing the tiles from the affected row onward.
+final class TileLayoutTests: XCTestCase {
+    private let metrics = TileLayout.Metrics(widthMax: 100, tileHeight: 50, padding: 10, isLeftToRight: true)
+
+    private func layout(_ widths: [CGFloat], _ metrics: TileLayout.Metrics? = nil) -> TileLayout {
+        var layout = TileLayout()
+        layout.update(ids: Array(widths.indices), widths: widths, metrics: metrics ?? self.metrics)
+        return layout
+    }
+
+    /// one tile's width changed, as `TilesView` hands it over: the full ids and widths of the refresh
+    private func resize(_ layout: inout TileLayout, _ index: Int, to width: CGFloat) {
+        var widths = layout.widths
+        widths[index] = width
+        layout.update(ids: layout.ids, widths: widths, metrics: layout.metrics!)
+    }
+
+    private func assertMatchesFreshLayout(_ layout: TileLayout, file: StaticString = #filePath, line: UInt = #line) {
+        var fresh = TileLayout()
+        fresh.update(ids: layout.ids, widths: layout.widths, metrics: layout.metrics!)
+        XCTAssertEqual(layout.origins, fresh.origins, "origins", file: file, line: line)
+        XCTAssertEqual(layout.rowOfTile, fresh.rowOfTile, "rowOfTile", file: file, line: line)
+        XCTAssertEqual(layout.signature, fresh.signature, "signature", file: file, line: line)
+        XCTAssertEqual(layout.maxX, fresh.maxX, "maxX", file: file, line: line)
+        XCTAssertEqual(layout.maxY, fresh.maxY, "maxY", file: file, line: line)
+    }
+
+    // MARK: - A. Packing
+
+    func testTilesWrapWhenTheRowIsFull() {
+        let l = layout([30, 30, 30])
+        XCTAssertEqual(l.origins, [CGPoint(x: 10, y: 10), CGPoint(x: 50, y: 10), CGPoint(x: 10, y: 70)])
+        XCTAssertEqual(l.rowOfTile, [0, 0, 1])
+        XCTAssertEqual(l.signature.rowStarts, [0, 2])
+        XCTAssertEqual(l.maxX, 90)
+        XCTAssertEqual(l.maxY, 130)
+    }
+
+    func testRightToLeftMirrorsThePacking() {
+        var rtl = metrics
+        rtl.isLeftToRight = false
+        let l = layout([30, 30, 30], rtl)
+        XCTAssertEqual(l.origins, [CGPoint(x: 60, y: 10), CGPoint(x: 20, y: 10), CGPoint(x: 60, y: 70)])
+        XCTAssertEqual(l.maxX, 90)
+    }
+
+    func testFractionalWidthsRoundDown() {
+        let l = layout([30.7, 30.7])
+        XCTAssertEqual(l.origins[1].x, 50, "10 + 30.7 + 10, rounded down")
+    }
+
+    func testEmptyLayoutHasOneEmptyRow() {
+        let l = layout([])
+        XCTAssertEqual(l.rowCount, 1)
+        XCTAssertEqual(l.maxX, 0)
+        XCTAssertEqual(l.maxY, 70)
+    }
+
+    func testTileWiderThanTheGridOpensRowOne() {
+        // kept as it always was: the oversized first tile wraps, leaving row 0 empty
+        let l = layout([150, 30])
+        XCTAssertEqual(l.signature.rowStarts, [0, 0, 1])
+        XCTAssertEqual(l.rowOfTile, [1, 2])
+    }
+
+    // MARK: - B. Incremental relayout
+
+    func testUnchangedWidthsRecomputeNothing() {
+        var l = layout([30, 30, 30])
+        l.update(ids: [0, 1, 2], widths: [30, 30, 30], metrics: metrics)
+        XCTAssertEqual(l.lastRecomputedCount, 0)
+    }
+
+    func testWidthChangeRecomputesOnlyItsRow() {
+        var wide = metrics
+        wide.widthMax = 1000
+        var l = layout(Array(repeating: 30, count: 2000), wide)
+        // 24 tiles per row: tile 100 sits in the row of tiles 96…119, and still fits at 31
+        resize(&l, 100, to: 31)
+        XCTAssertEqual(l.lastRecomputedCount, 24)
+        assertMatchesFreshLayout(l)
+    }
+
+    func testGrowingATileReflowsTheFollowingRows() {
+        var wide = metrics
+        wide.widthMax = 1000
+        var l = layout(Array(repeating: 30, count: 2000), wide)
+        resize(&l, 100, to: 300)
+        XCTAssertEqual(l.lastRecomputedCount, 2000 - 96)
+        assertMatchesFreshLayout(l)
+    }
+
+    func testShrinkingARowsFirstTilePullsItIntoThePreviousRow() {
+        var l = layout([30, 30, 40], .init(widthMax: 110, tileHeight: 50, padding: 10, isLeftToRight: true))
+        XCTAssertEqual(l.rowCount, 2)
+        resize(&l, 2, to: 10)
+        XCTAssertEqual(l.rowCount, 1)
+        assertMatchesFreshLayout(l)
+    }
+
+    func testInsertedRemovedAndResizedTilesMatchAFreshLayout() {
+        var seed: UInt64 = 42
+        func next(_ bound: Int) -> Int {
+            seed = seed &* 6364136223846793005 &+ 1442695040888963407
+            return Int((seed >> 33) % UInt64(bound))
+        }
+        var ids = Array(0..<200)
+        var widths = ids.map { _ in CGFloat(20 + next(60)) }
+        var l = TileLayout()
+        l.update(ids: ids, widths: widths, metrics: metrics)
+        for _ in 0..<300 {
+            switch next(3) {
+                case 0:
+                    let at = next(ids.count + 1)
+                    ids.insert(1000 + next(1000), at: at)
+                    widths.insert(CGFloat(20 + next(60)), at: at)
+                case 1 where ids.count > 1:
+                    let at = next(ids.count)
+                    ids.remove(at: at)
+                    widths.remove(at: at)
+                default:
+                    widths[next(widths.count)] = CGFloat(20 + next(60))
+            }
+            l.update(ids: ids, widths: widths, metrics: metrics)
+            assertMatchesFreshLayout(l)
+        }
+    }
+
+    func testOversizedFirstTileRelayoutMatchesAFreshLayout() {
+        var l = layout([150, 30, 30, 30])
+        resize(&l, 2, to: 40)
+        assertMatchesFreshLayout(l)
+        resize(&l, 0, to: 20)
+        assertMatchesFreshLayout(l)
+        resize(&l, 0, to: 150)
+        assertMatchesFreshLayout(l)
+    }
+
+    func testMetricsChangeRelaysOutEverything() {
+        var l = layout(Array(repeating: 30, count: 50))
+        var narrower = metrics
+        narrower.widthMax = 90
+        l.update(ids: l.ids, widths: l.widths, metrics: narrower)
+        XCTAssertEqual(l.lastRecomputedCount, 50)
+        assertMatchesFreshLayout(l)
+    }
+
+    func testRowSignatureTracksRowBreaksNotJustTiles() {
+        var l = layout([30, 30, 30])
+        let before = l.signature
+        resize(&l, 0, to: 25)
+        XCTAssertEqual(l.signature, before, "same tiles in the same rows")
+        resize(&l, 0, to: 10)
+        resize(&l, 1, to: 10)
+        XCTAssertNotEqual(l.signature, before, "the third tile moved up a row")
+        XCTAssertEqual(l.ids, before.ids)
+    }
+
+    // MARK: - C. Benchmarks
+
+    func testBenchmarkFullLayout50Tiles() { measureFullLayout(50) }
+    func testBenchmarkFullLayout500Tiles() { measureFullLayout(500) }
+    func testBenchmarkFullLayout2000Tiles() { measureFullLayout(2000) }
+    func testBenchmarkOneTitleChange50Tiles() { measureOneTitleChange(50) }
+    func testBenchmarkOneTitleChange500Tiles() { measureOneTitleChange(500) }
+    func testBenchmarkOneTitleChange2000Tiles() { measureOneTitleChange(2000) }
+
+    private func benchmarkWidths(_ count: Int) -> [CGFloat] {
+        (0..<count).map { CGFloat(180 + ($0 * 37) % 140) }
+    }
+
+    private func measureFullLayout(_ count: Int) {
+        let widths = benchmarkWidths(count)
+        let ids = Array(0..<count)
+        let wide = TileLayout.Metrics(widthMax: 1800, tileHeight: 200, padding: 4, isLeftToRight: true)
+        measure {
+            for _ in 0..<100 {
+                var l = TileLayout()
+                l.update(ids: ids, widths: widths, metrics: wide)
+                XCTAssertEqual(l.rowOfTile.count, count)
+            }
+        }
+    }
+
+    /// what `App.refreshOpenUiAfterExternalEvent` costs the layout when one window's title changed
+    private func measureOneTitleChange(_ count: Int) {
+        var widths = benchmarkWidths(count)
+        let ids = Array(0..<count)
+        let wide = TileLayout.Metrics(widthMax: 1800, tileHeight: 200, padding: 4, isLeftToRight: true)
+        var l = TileLayout()
+        l.update(ids: ids, widths: widths, metrics: wide)
+        measure {
+            for i in 0..<100 {
+                widths[count / 2] = CGFloat(180 + i % 2)
+                l.update(ids: ids, widths: widths, metrics: wide)
+            }
+        }
+    }
+}
@@ -17,7 +17,9 @@ class TilesView {
     static var noWindowLabel = NSTextField(labelWithString: NSLocalizedString("No Window", comment: ""))
     private(set) static var searchMode: SearchMode = .off
     static var rows = [[TileView]]()
-    private static var lastRowSignature = [Int]()
+    private static var lastRowSignature = TileLayout.RowSignature()
+    /// one cached layout per size, so auto-size probing large/medium/small doesn't invalidate the others
+    private static var tileLayouts = [AppearanceSizePreference: TileLayout]()
     static var recycledViews = [TileView]()
     static var thumbnailsWidth = CGFloat(0.0)
     static var thumbnailsHeight = CGFloat(0.0)
@@ -327,7 +329,8 @@ class TilesView {
         thumbnailUnderLayer = TileUnderLayer()
         thumbnailOverView = TileOverView()
         thumbnailOverView.scrollView = scrollView
-        lastRowSignature.removeAll()
+        lastRowSignature = TileLayout.RowSignature()
+        tileLayouts.removeAll()
         TileView.invalidateTitleAttributesCache()
         cachedSearchBarHeight = nil
         Self.updateCachedSizes()
@@ -377,6 +380,10 @@ class TilesView {
     }
 
     static func navigateUpOrDown(_ direction: Direction, allowWrap: Bool = true) {
+        if let row = Windows.selectedWindow()?.rowIndex, row == (direction == .down ? rows.count - 1 : 0) {
+            // leaving the last row, or wrapping from the first: a search's hidden tail comes next
+            Windows.rankTail()
+        }
         let selectedIndex = SwitcherSession.current?.selectedIndex ?? 0
         guard selectedIndex < TilesView.recycledViews.count else { return }
         let focusedViewFrame = TilesView.recycledViews[selectedIndex].frame
@@ -397,12 +404,13 @@ class TilesView {
 
     static func updateItemsAndLayout(_ preservedScrollOrigin: CGPoint?) {
         var widthMax = TilesPanel.maxThumbnailsWidth().rounded()
+        var measured: MeasuredTiles?
         if Preferences.effectiveAppearanceSize(SwitcherSession.activeShortcutIndex) == .auto {
-            resolveAutoSize(widthMax)
-            Self.updateCachedSizes()
+            // the size it settles on was measured last, so its tiles don't need measuring again
+            measured = resolveAutoSize(widthMax)
             widthMax = TilesPanel.maxThumbnailsWidth().rounded()
         }
-        if let (maxX, maxY, labelHeight, rowSignature) = layoutTileViews(widthMax) {
+        if let (maxX, maxY, labelHeight, rowSignature) = layoutTileViews(widthMax, measured) {
             layoutParentViews(maxX, widthMax, maxY, labelHeight)
             centerRows(TilesView.thumbnailsWidth)
             if rowSignature != lastRowSignature {
@@ -438,66 +446,29 @@ class TilesView {
         scrollView.reflectScrolledClipView(scrollView.contentView)
     }
 
-    private static func resolveAutoSize(_ widthMax: CGFloat) {
+    private typealias MeasuredTiles = (ids: [Int], widths: [CGFloat])
+
+    private static func resolveAutoSize(_ widthMax: CGFloat) -> MeasuredTiles? {
         let searchReservedHeight: CGFloat = searchMode == .off ? 0 : searchBarHeight() + 10
         let heightMax = max(0, TilesPanel.maxThumbnailsHeight() - searchReservedHeight)
         for size in [AppearanceSizePreference.large, .medium, .small] {
             Appearance.applySize(size)
             Self.updateCachedSizes()
-            let maxY = dryRunLayoutTileViews(widthMax)
-            if size == .small || maxY <= heightMax { return }
-        }
-    }
-
-    private static func dryRunLayoutTileViews(_ widthMax: CGFloat) -> CGFloat {
-        let labelHeight = Self.layoutCache.labelHeight
-        let height = TileView.height(labelHeight)
-        let isLeftToRight = App.shared.userInterfaceLayoutDirection == .leftToRight
-        let startingX = isLeftToRight ? Appearance.interCellPadding : widthMax - Appearance.interCellPadding
-        var currentX = startingX
-        var currentY = Appearance.interCellPadding
-        var maxY = currentY + height + Appearance.interCellPadding
-        var index = 0
-        while index < TilesView.recycledViews.count {
-            guard SwitcherSession.isActive else { return maxY }
-            defer { index += 1 }
-            let view = TilesView.recycledViews[index]
-            guard index < Windows.list.count else { break }
-            let window = Windows.list[index]
-            guard Windows.shouldDisplay(window) else { view.frame = .zero; continue }
-            view.updateRecycledCellWithNewContent(window, index, height)
-            let width = view.frame.size.width
-            let projectedX = projectedWidth(currentX, width).rounded(.down)
-            if needNewLine(projectedX, widthMax) {
-                currentX = startingX
-                currentY = (currentY + height + Appearance.interCellPadding).rounded(.down)
-                currentX = projectedWidth(currentX, width).rounded(.down)
-                maxY = max(currentY + height + Appearance.interCellPadding, maxY)
-            } else {
-                currentX = projectedX
-            }
+            guard let tiles = measureTileViews(TileView.height(Self.layoutCache.labelHeight)) else { return nil }
+            tileLayouts[size, default: TileLayout()].update(ids: tiles.ids, widths: tiles.widths, metrics: tileLayoutMetrics(widthMax))
+            if size == .small || tileLayouts[size]!.maxY <= heightMax { return tiles }
         }
-        return maxY
+        return nil
     }
 
-    private static func layoutTileViews(_ widthMax: CGFloat) -> (CGFloat, CGFloat, CGFloat, [Int])? {
-        let labelHeight = Self.layoutCache.labelHeight
-        let height = TileView.height(labelHeight)
-        let isLeftToRight = App.shared.userInterfaceLayoutDirection == .leftToRight
-        let startingX = isLeftToRight ? Appearance.interCellPadding : widthMax - Appearance.interCellPadding
-        var currentX = startingX
-        var currentY = Appearance.interCellPadding
-        var maxX = CGFloat(0)
-        var maxY = currentY + height + Appearance.interCellPadding
-        var newViews = [TileView]()
-        var rowSignature = [Int]()
-        rows.removeAll(keepingCapacity: true)
-        rows.append([TileView]())
-        var index = 0
-        while index < TilesView.recycledViews.count {
+    /// fill the recycled views with the current windows, and collect the displayed ones (index in
+    /// `recycledViews`) with their width at the current size
+    private static func measureTileViews(_ height: CGFloat) -> MeasuredTiles? {
+        var tiles: MeasuredTiles = ([], [])
+        tiles.ids.reserveCapacity(Windows.list.count)
+        tiles.widths.reserveCapacity(Windows.list.count)
+        for (index, view) in TilesView.recycledViews.enumerated() {
             guard SwitcherSession.isActive else { return nil }
-            defer { index = index + 1 }
-            let view = TilesView.recycledViews[index]
             if index < Windows.list.count {
                 let window = Windows.list[index]
                 guard Windows.shouldDisplay(window) else {
@@ -505,24 +476,8 @@ class TilesView {
                     continue
                 }
                 view.updateRecycledCellWithNewContent(window, index, height)
-                let width = view.frame.size.width
-                let projectedX = projectedWidth(currentX, width).rounded(.down)
-                if needNewLine(projectedX, widthMax) {
-                    currentX = startingX
-                    currentY = (currentY + height + Appearance.interCellPadding).rounded(.down)
-                    view.frame.origin = CGPoint(x: localizedCurrentX(currentX, width), y: currentY)
-                    currentX = projectedWidth(currentX, width).rounded(.down)
-                    maxY = max(currentY + height + Appearance.interCellPadding, maxY)
-                    rows.append([TileView]())
-                } else {
-                    view.frame.origin = CGPoint(x: localizedCurrentX(currentX, width), y: currentY)
-                    currentX = projectedX
-                    maxX = max(isLeftToRight ? currentX : widthMax - currentX, maxX)
-                }
-                rows[rows.count - 1].append(view)
-                newViews.append(view)
-                rowSignature.append(index)
-                window.rowIndex = rows.count - 1
+                tiles.ids.append(index)
+                tiles.widths.append(view.frame.size.width)
             } else {
                 // release images and stale window references from unused recycledViews; they take lots of RAM
                 view.thumbnail.releaseImage()
@@ -530,6 +485,32 @@ class TilesView {
                 view.window_ = nil
             }
         }
+        return tiles
+    }
+
+    private static func tileLayoutMetrics(_ widthMax: CGFloat) -> TileLayout.Metrics {
+        TileLayout.Metrics(widthMax: widthMax, tileHeight: TileView.height(Self.layoutCache.labelHeight),
+            padding: Appearance.interCellPadding, isLeftToRight: App.shared.userInterfaceLayoutDirection == .leftToRight)
+    }
+
+    private static func layoutTileViews(_ widthMax: CGFloat, _ measured: MeasuredTiles?) -> (CGFloat, CGFloat, CGFloat, TileLayout.RowSignature)? {
+        let labelHeight = Self.layoutCache.labelHeight
+        guard let tiles = measured ?? measureTileViews(TileView.height(labelHeight)) else { return nil }
+        let size = Appearance.resolvedSize
+        tileLayouts[size, default: TileLayout()].update(ids: tiles.ids, widths: tiles.widths, metrics: tileLayoutMetrics(widthMax))
+        let layout = tileLayouts[size]!
+        rows.removeAll(keepingCapacity: true)
+        rows.append(contentsOf: repeatElement([TileView](), count: layout.rowCount))
+        var newViews = [TileView]()
+        newViews.reserveCapacity(tiles.ids.count)
+        for (i, index) in tiles.ids.enumerated() {
+            let view = TilesView.recycledViews[index]
+            let row = layout.rowOfTile[i]
+            view.frame.origin = layout.origins[i]
+            rows[row].append(view)
+            newViews.append(view)
+            Windows.list[index].rowIndex = row
+        }
         scrollView.documentView!.subviews = newViews
         scrollView.documentView!.addSubview(thumbnailOverView)
         thumbnailOverView.scrollView = scrollView
@@ -537,25 +518,7 @@ class TilesView {
         if thumbnailUnderLayer.superlayer !== docLayer {
             docLayer.insertSublayer(thumbnailUnderLayer, at: 0)
         }
-        return (maxX, maxY, labelHeight, rowSignature)
-    }
-
-    private static func needNewLine(_ projectedX: CGFloat, _ widthMax: CGFloat) -> Bool {
-        if App.shared.userInterfaceLayoutDirection == .leftToRight {
-            return projectedX > widthMax
-        }
-        return projectedX < 0
-    }
-
-    private static func projectedWidth(_ currentX: CGFloat, _ width: CGFloat) -> CGFloat {
-        if App.shared.userInterfaceLayoutDirection == .leftToRight {
-            return currentX + width + Appearance.interCellPadding
-        }
-        return currentX - width - Appearance.interCellPadding
-    }
-
-    private static func localizedCurrentX(_ currentX: CGFloat, _ width: CGFloat) -> CGFloat {
-        App.shared.userInterfaceLayoutDirection == .leftToRight ? currentX : currentX - width
+        return (layout.maxX, layout.maxY, labelHeight, layout.signature)
     }
 
     private static func layoutParentViews(_ maxX: CGFloat, _ widthMax: CGFloat, _ maxY: CGFloat, _ labelHeight: CGFloat) {
@@ -665,6 +628,22 @@ class TilesView {
         }
     }
 
+    /// Upper bound on how many tiles one screenful of the panel can show: narrowest tiles, on every row that fits
+    static func tilesPerScreenful() -> Int {
+        let tileHeight = TileView.height(layoutCache.labelHeight) + Appearance.interCellPadding
+        let tileWidth = TileView.minThumbnailWidth() + Appearance.interCellPadding
+        guard tileHeight > 0 && tileWidth > 0 else { return Int.max }
+        let rows = (TilesPanel.maxThumbnailsHeight() / tileHeight).rounded(.up)
+        let columns = (TilesPanel.maxThumbnailsWidth() / tileWidth).rounded(.up)
+        return Int(rows * columns)
+    }
+
+    static func isTileInViewport(_ index: Int) -> Bool {
+        guard let scrollView, index < recycledViews.count else { return false }
+        let frame = recycledViews[index].frame
+        return frame != .zero && scrollView.documentVisibleRect.intersects(frame)
+    }
+
     static func windowIdsInViewport() -> Set<CGWindowID> {
         guard let scrollView else { return [] }
         let visibleBounds = scrollView.documentVisibleRect
@@ -732,7 +711,10 @@ class ScrollView: NSScrollView {
     }
 
     @objc private func scrollingStarted() { isCurrentlyScrolling = true }
-    @objc private func scrollingEnded() { isCurrentlyScrolling = false }
+    @objc private func scrollingEnded() {
+        isCurrentlyScrolling = false
+        Windows.viewportScrolled()
+    }
 
     /// holding shift and using the scrolling wheel will generate a horizontal movement
     /// shift can be part of shortcuts so we force shift scrolls to be vertical
@@ -745,6 +727,7 @@ class ScrollView: NSScrollView {
         } else {
             super.scrollWheel(with: event)
         }
+        Windows.viewportScrolled()
     }
 }
 
@@ -311,8 +311,8 @@ class Applications {
     /// signal — the WS ordered-out bit conflates minimized with closing/other-Space), and tab siblings.
     /// Shares the "wid-N-generic" dedup/throttle key so it never double-reads a window the discovery pass
     /// just refreshed. Runs for every tracked window on each show, so minimized stays fresh from AX.
-    static func refreshWindowTitleAndTabs(_ axWindow: AXUIElement, _ wid: CGWindowID, _ app: Application, _ reconcileTabs: Bool = true) {
-        AXCallScheduler.shared.schedule(key: "wid-\(wid)-generic", context: app.debugId, pid: app.pid, scan: true) { [weak app] in
+    static func refreshWindowTitleAndTabs(_ axWindow: AXUIElement, _ wid: CGWindowID, _ app: Application, _ reconcileTabs: Bool = true, sessionScoped: Bool = false) {
+        AXCallScheduler.shared.schedule(key: "wid-\(wid)-generic", context: app.debugId, pid: app.pid, scan: true, sessionScoped: sessionScoped) { [weak app] in
             guard let app else { return }
             guard wid != 0 else { return }
             // TilesPanel.shared is nil until the switcher is first built; discovery can now run before that
@@ -343,8 +343,10 @@ class Applications {
                     if reconcileTabs, tabSiblingTitles != nil || window.tabbedSiblingWids != nil {
                         if TabGroup.updateState(window, tabSiblingTitles) { changed = true }
                     }
-                    if changed && SwitcherSession.isActive {
-                        App.refreshOpenUiAfterExternalEvent([window])
+                    if changed {
+                        // a new title or minimized state redraws the window: the next show retakes its thumbnail
+                        WindowThumbnails.markDirty([wid])
+                        if SwitcherSession.isActive { App.refreshOpenUiAfterExternalEvent([window]) }
                     }
                 }
             }
@@ -360,7 +362,8 @@ class Applications {
             guard !window.isWindowlessApp,
                   let axUiElement = window.axUiElement,
                   let wid = window.cgWindowId else { continue }
-            refreshWindowTitleAndTabs(axUiElement, wid, window.application)
+            // a review for the open switcher is moot once it closes
+            refreshWindowTitleAndTabs(axUiElement, wid, window.application, sessionScoped: SwitcherSession.isActive)
         }
     }
 
@@ -435,7 +438,7 @@ class Applications {
         guard SwitcherSession.isActive else { return }
         dockBadgeThrottler.throttleOrProceed {
             let dockPid = list.first { $0.bundleIdentifier == "com.apple.dock" }?.pid
-            AXCallScheduler.shared.schedule(key: "badges", context: "badges", pid: dockPid) {
+            AXCallScheduler.shared.schedule(key: "badges", context: "badges", pid: dockPid, sessionScoped: true) {
                 guard let dockPid,
                     let axDockChildren = try AXUIElementCreateApplication(dockPid).attributes([kAXChildrenAttribute]).children,
                     let axListAttrs = (axDockChildren.lazy.compactMap { try? $0.attributes([kAXRoleAttribute, kAXChildrenAttribute]) }.first { $0.role == kAXListRole }),
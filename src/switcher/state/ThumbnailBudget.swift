@@ -0,0 +1,128 @@
+import Cocoa
+
+/// Bookkeeping for the thumbnails `Window.thumbnail` holds: how many bytes each one costs, which to evict
+/// when the total passes the byte budget, and which are stale enough to capture again. Pure (no images,
+/// clocks or AppKit — the caller passes sizes and `nowNs`), so eviction order and budget accounting are
+/// unit-testable (same pattern as `WindowOrderResolver`). `WindowThumbnails` owns the one instance and turns
+/// its answers into dropped images and skipped captures.
+///
+/// - **LRU by showing**: the least recently shown thumbnails go first; never-shown ones by capture order.
+///   Tiles on screen right now (`markShown`) and the thumbnail being stored are never evicted.
+/// - **Dirtiness**: a thumbnail is stale when it's missing (never captured, or evicted), marked dirty (an
+///   event changed the window and its recapture may have been skipped), or older than `reuseWindowNs`. Move,
+///   resize and title events mark dirty, so the age limit only backstops content redrawn without an event.
+struct ThumbnailBudget {
+    /// long enough to span the gap between two uses of the switcher; see `thumbnailReuseSeconds`
+    static let defaultReuseWindowNs: UInt64 = 30_000_000_000
+
+    struct Stats: Equatable {
+        var entries = 0
+        var bytesHeld = 0
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+        var hitRate: Double { hits + misses == 0 ? 0 : Double(hits) / Double(hits + misses) }
+    }
+
+    private struct Entry {
+        var bytes: Int
+        var capturedNs: UInt64
+        var storedSeq: Int
+        var lastShownTick = 0
+        var dirty = false
+    }
+
+    private(set) var budgetBytes: Int
+    /// a clean thumbnail captured this recently is reused when the switcher shows again
+    var reuseWindowNs: UInt64
+    private(set) var stats = Stats()
+    private var entries = [CGWindowID: Entry]()
+    private var onScreen = Set<CGWindowID>()
+    private var tick = 0
+    private var nextSeq = 0
+
+    init(budgetBytes: Int, reuseWindowNs: UInt64 = Self.defaultReuseWindowNs) {
+        self.budgetBytes = budgetBytes
+        self.reuseWindowNs = reuseWindowNs
+    }
+
+    /// Record a fresh, clean capture of `wid`; returns the windows whose thumbnails must be dropped to get
+    /// back under budget, least recently shown first
+    mutating func store(_ wid: CGWindowID, bytes: Int, nowNs: UInt64) -> [CGWindowID] {
+        let shownTick = entries[wid]?.lastShownTick ?? 0
+        stats.bytesHeld += bytes - (entries[wid]?.bytes ?? 0)
+        entries[wid] = Entry(bytes: bytes, capturedNs: nowNs, storedSeq: nextSeq, lastShownTick: shownTick)
+        nextSeq += 1
+        stats.entries = entries.count
+        return evictOverBudget(sparing: wid)
+    }
+
+    /// The tiles now on screen. Newly visible ones count as a hit (thumbnail held) or a miss; all of them
+    /// become the most recently shown, and are spared from eviction until the next call.
+    mutating func markShown(_ wids: Set<CGWindowID>) {
+        tick += 1
+        for wid in wids {
+            if !onScreen.contains(wid) {
+                if entries[wid] != nil { stats.hits += 1 } else { stats.misses += 1 }
+            }
+            entries[wid]?.lastShownTick = tick
+        }
+        onScreen = wids
+    }
+
+    mutating func markDirty(_ wids: [CGWindowID]) {
+        for wid in wids { entries[wid]?.dirty = true }
+    }
+
+    func needsCapture(_ wid: CGWindowID, nowNs: UInt64) -> Bool {
+        guard let entry = entries[wid], !entry.dirty else { return true }
+        return nowNs &- entry.capturedNs > reuseWindowNs
+    }
+
+    /// the window is gone (or its thumbnail was dropped elsewhere): stop accounting for it
+    mutating func remove(_ wid: CGWindowID) {
+        guard let entry = entries.removeValue(forKey: wid) else { return }
+        stats.bytesHeld -= entry.bytes
+        stats.entries = entries.count
+        onScreen.remove(wid)
+    }
+
+    mutating func setBudget(_ bytes: Int) -> [CGWindowID] {
+        budgetBytes = bytes
+        return evictOverBudget(sparing: nil)
+    }
+
+    /// Indexes of the tiles still holding one of the `evicted` thumbnails in their layer, given the wid each
+    /// recycled `TileView` last showed (shown or not). Dropping `Window.thumbnail` alone leaves the image alive there.
+    static func tilesHolding(_ evicted: [CGWindowID], tileWids: [CGWindowID?]) -> [Int] {
+        guard !evicted.isEmpty else { return [] }
+        let evicted = Set(evicted)
+        return tileWids.indices.filter { tileWids[$0].map { evicted.contains($0) } ?? false }
+    }
+
+    /// Aspect-fit `size` into `maxSize` (pixels): the size to keep a thumbnail at, or nil when it already
+    /// fits. Same rule as the capture size `SCStreamConfiguration.forWindow` asks ScreenCaptureKit for.
+    static func storageSize(_ size: CGSize, fitting maxSize: CGSize) -> CGSize? {
+        guard size.width > 0, size.height > 0, maxSize.width > 0, maxSize.height > 0 else { return nil }
+        let scale = min(maxSize.width / size.width, maxSize.height / size.height)
+        guard scale < 1 else { return nil }
+        return CGSize(width: max(1, (size.width * scale).rounded()), height: max(1, (size.height * scale).rounded()))
+    }
+
+    private mutating func evictOverBudget(sparing spared: CGWindowID?) -> [CGWindowID] {
+        guard stats.bytesHeld > budgetBytes else { return [] }
+        let candidates = entries
+            .filter { $0.key != spared && !onScreen.contains($0.key) }
+            .sorted { ($0.value.lastShownTick, $0.value.storedSeq) < ($1.value.lastShownTick, $1.value.storedSeq) }
+        var evicted = [CGWindowID]()
+        for (wid, entry) in candidates {
+            guard stats.bytesHeld > budgetBytes else { break }
+            entries[wid] = nil
+            stats.bytesHeld -= entry.bytes
+            evicted.append(wid)
+        }
+        stats.evictions += evicted.count
+        stats.entries = entries.count
+        return evicted
+    }
+}
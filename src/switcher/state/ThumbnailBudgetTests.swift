@@ -0,0 +1,161 @@
+import XCTest
+
+/// Pins the thumbnail budget: byte accounting, least-recently-shown eviction that never touches tiles on
+/// screen, staleness (missing / dirty / old) deciding what the next show recaptures, and the hit rate the
+/// debug profile reports.
+final class ThumbnailBudgetTests: XCTestCase {
+    private let second: UInt64 = 1_000_000_000
+
+    // MARK: - A. Accounting
+
+    func testStoringAndReplacingAThumbnailTracksItsBytes() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        XCTAssertEqual(budget.store(1, bytes: 300, nowNs: 0), [])
+        XCTAssertEqual(budget.store(2, bytes: 200, nowNs: 0), [])
+        XCTAssertEqual(budget.store(1, bytes: 100, nowNs: 0), [], "a recapture replaces, not adds")
+        XCTAssertEqual(budget.stats.bytesHeld, 300)
+        XCTAssertEqual(budget.stats.entries, 2)
+    }
+
+    func testRemovingAWindowReleasesItsBytes() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        _ = budget.store(1, bytes: 300, nowNs: 0)
+        budget.remove(1)
+        budget.remove(42)
+        XCTAssertEqual(budget.stats.bytesHeld, 0)
+        XCTAssertEqual(budget.stats.entries, 0)
+    }
+
+    // MARK: - B. Eviction
+
+    func testOverBudgetEvictsLeastRecentlyShownFirst() {
+        var budget = ThumbnailBudget(budgetBytes: 300)
+        for wid: CGWindowID in 1...3 { _ = budget.store(wid, bytes: 100, nowNs: 0) }
+        budget.markShown([1])
+        budget.markShown([3])
+        budget.markShown([2])
+        budget.markShown([])
+        XCTAssertEqual(budget.store(4, bytes: 150, nowNs: 0), [1, 3], "1 was shown longest ago, then 3")
+        XCTAssertEqual(budget.stats.bytesHeld, 250)
+        XCTAssertEqual(budget.stats.evictions, 2)
+    }
+
+    func testNeverShownThumbnailsGoFirstInCaptureOrder() {
+        var budget = ThumbnailBudget(budgetBytes: 300)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        budget.markShown([1])
+        budget.markShown([])
+        _ = budget.store(2, bytes: 100, nowNs: 0)
+        _ = budget.store(3, bytes: 100, nowNs: 0)
+        XCTAssertEqual(budget.store(4, bytes: 100, nowNs: 0), [2])
+    }
+
+    func testTilesOnScreenAndTheNewThumbnailAreNeverEvicted() {
+        var budget = ThumbnailBudget(budgetBytes: 100)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        budget.markShown([1])
+        XCTAssertEqual(budget.store(2, bytes: 100, nowNs: 0), [], "1 is on screen, 2 was just captured")
+        XCTAssertEqual(budget.stats.bytesHeld, 200, "over budget until something leaves the screen")
+        budget.markShown([2])
+        XCTAssertEqual(budget.store(3, bytes: 50, nowNs: 0), [1])
+    }
+
+    func testShrinkingTheBudgetEvicts() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        for wid: CGWindowID in 1...4 { _ = budget.store(wid, bytes: 100, nowNs: 0) }
+        XCTAssertEqual(budget.setBudget(250), [1, 2])
+        XCTAssertEqual(budget.budgetBytes, 250)
+    }
+
+    func testEvictedThumbnailNeedsCaptureAgain() {
+        var budget = ThumbnailBudget(budgetBytes: 100)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        _ = budget.store(2, bytes: 100, nowNs: 0)
+        XCTAssertTrue(budget.needsCapture(1, nowNs: 0))
+        XCTAssertFalse(budget.needsCapture(2, nowNs: 0))
+    }
+
+    func testEvictedThumbnailIsReleasedFromEveryTileHoldingIt() {
+        var budget = ThumbnailBudget(budgetBytes: 100)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        let evicted = budget.store(2, bytes: 100, nowNs: 0)
+        XCTAssertEqual(evicted, [1])
+        // tile 0 shows window 1, tile 3 is a hidden recycled view that last showed it
+        XCTAssertEqual(ThumbnailBudget.tilesHolding(evicted, tileWids: [1, 2, nil, 1]), [0, 3])
+        XCTAssertEqual(ThumbnailBudget.tilesHolding([], tileWids: [1, 2]), [])
+    }
+
+    // MARK: - C. Staleness
+
+    func testRecentCleanThumbnailIsReused() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        _ = budget.store(1, bytes: 100, nowNs: 5 * second)
+        XCTAssertFalse(budget.needsCapture(1, nowNs: 5 * second + budget.reuseWindowNs))
+    }
+
+    func testCleanThumbnailIsReusedAcrossATypicalHideShowGap() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        _ = budget.store(1, bytes: 100, nowNs: 5 * second)
+        _ = budget.store(2, bytes: 100, nowNs: 5 * second)
+        budget.markShown([1, 2])
+        budget.markShown([])
+        // the user switches, works a few seconds, then opens the switcher again; window 2 was resized meanwhile
+        budget.markDirty([2])
+        XCTAssertFalse(budget.needsCapture(1, nowNs: 13 * second), "unchanged window: reuse its thumbnail")
+        XCTAssertTrue(budget.needsCapture(2, nowNs: 13 * second), "changed window: retake it")
+    }
+
+    func testReuseWindowIsConfigurable() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000, reuseWindowNs: 2 * second)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        XCTAssertTrue(budget.needsCapture(1, nowNs: 3 * second))
+        budget.reuseWindowNs = 5 * second
+        XCTAssertFalse(budget.needsCapture(1, nowNs: 3 * second))
+    }
+
+    func testOldThumbnailIsRecaptured() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        _ = budget.store(1, bytes: 100, nowNs: 5 * second)
+        XCTAssertTrue(budget.needsCapture(1, nowNs: 5 * second + budget.reuseWindowNs + 1))
+    }
+
+    func testDirtyThumbnailIsRecapturedUntilTheNextCapture() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        budget.markDirty([1, 99])
+        XCTAssertTrue(budget.needsCapture(1, nowNs: 0))
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        XCTAssertFalse(budget.needsCapture(1, nowNs: 0))
+    }
+
+    func testNeverCapturedWindowNeedsCapture() {
+        XCTAssertTrue(ThumbnailBudget(budgetBytes: 1_000).needsCapture(7, nowNs: 0))
+    }
+
+    // MARK: - D. Hit rate
+
+    func testNewlyVisibleTilesCountAsHitsOrMisses() {
+        var budget = ThumbnailBudget(budgetBytes: 1_000)
+        _ = budget.store(1, bytes: 100, nowNs: 0)
+        budget.markShown([1, 2])
+        budget.markShown([1, 2]) // a refresh with the same tiles: nothing new became visible
+        XCTAssertEqual(budget.stats.hits, 1)
+        XCTAssertEqual(budget.stats.misses, 1)
+        XCTAssertEqual(budget.stats.hitRate, 0.5)
+        budget.markShown([])
+        budget.markShown([1])
+        XCTAssertEqual(budget.stats.hits, 2)
+    }
+
+    // MARK: - E. Storage size
+
+    func testDownscalesToFitTheLargestTile() {
+        let size = ThumbnailBudget.storageSize(CGSize(width: 5120, height: 2880), fitting: CGSize(width: 640, height: 640))
+        XCTAssertEqual(size, CGSize(width: 640, height: 360))
+    }
+
+    func testSmallerImagesKeepTheirSize() {
+        XCTAssertNil(ThumbnailBudget.storageSize(CGSize(width: 300, height: 200), fitting: CGSize(width: 640, height: 640)))
+        XCTAssertNil(ThumbnailBudget.storageSize(CGSize(width: 300, height: 200), fitting: .zero))
+    }
+}
@@ -23,10 +23,17 @@ class Window {
     var application: Application
     var rowIndex: Int?
     var debugId: String!
-    var lastSearchQuery: String?
+    /// Any write (a fresh cache, or an invalidation after a title change) supersedes a staged rank
+    var lastSearchQuery: String? { didSet { swStaged = nil } }
+    /// A rank `Windows.sort` stopped advancing part-way; `Search` resumes it instead of starting over
+    var swStaged: (key: String, match: SearchTestable.StagedMatch)?
+    /// The `Windows` sort whose ranked search prefix this window is in; while a tail is hidden, only the prefix shows
+    var searchPrefixGeneration = 0
     var swAppResults: [SWResult] = []
     var swTitleResults: [SWResult] = []
     var swBestSimilarity = 0.0
+    var titleSearchIndex: SearchTestable.Indexed?
+    var appNameSearchIndex: SearchTestable.Indexed?
 
     /// Forwards every `WindowState` field by name — `window.title` resolves to `state.title`,
     /// `window.isFullscreen = true` writes through. Replaces a stack of one-per-field computed
@@ -151,6 +158,7 @@ class Window {
 
     func refreshThumbnail(_ screenshot: CALayerContents) {
         thumbnail = screenshot
+        WindowThumbnails.didStore(self, screenshot)
         if !SwitcherSession.isActive || !shouldShowTheUser { return }
         if let position, let size,
            let view = (TilesView.recycledViews.first { $0.window_?.cgWindowId == cgWindowId }) {
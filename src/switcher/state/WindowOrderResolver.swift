@@ -65,6 +65,86 @@ enum WindowOrderResolver {
         return order == .orderedAscending
     }
 
+    /// The first `limit` windows of the search order, exactly as a stable sort by
+    /// `isOrderedBefore(searchActive: true)` would put them, without finishing every window's rank.
+    /// `facts[i]` holds window i's rank so far and `ceilings[i]` the best relevance its unfinished tiers
+    /// could still reach (nil once final); `advance(i)` runs its next tier band. The best `limit` windows are
+    /// kept in a bounded heap, and a window is only advanced while its ceiling could still displace the
+    /// heap's worst, so the T5/T6 work is skipped for most of a long list once the heap fills with strong
+    /// matches. Returns the prefix in order, and every other index in input order (not ranked).
+    static func searchRankedPrefix(_ facts: [OrderWindow], ceilings: [Double?], limit: Int,
+                                   advance: (Int) -> (relevance: Double, ceiling: Double?)) -> (prefix: [Int], rest: [Int]) {
+        guard limit > 0 else { return ([], Array(facts.indices)) }
+        var facts = facts
+        // ties keep input order, as with `Array.sort`
+        func precedes(_ a: OrderWindow, _ i: Int, _ b: OrderWindow, _ j: Int) -> Bool {
+            if isOrderedBefore(a, b, searchActive: true) { return true }
+            return !isOrderedBefore(b, a, searchActive: true) && i < j
+        }
+        func before(_ i: Int, _ j: Int) -> Bool { precedes(facts[i], i, facts[j], j) }
+        // max-heap under `before`: heap[0] is the worst of the best `limit` so far
+        var heap = [Int]()
+        heap.reserveCapacity(limit)
+        var rest = [Int]()
+        func siftUp(_ child: Int) {
+            var c = child
+            while c > 0 {
+                let p = (c - 1) / 2
+                if !before(heap[p], heap[c]) { return }
+                heap.swapAt(p, c)
+                c = p
+            }
+        }
+        func siftDown(_ parent: Int) {
+            var p = parent
+            while true {
+                var worst = p
+                let left = 2 * p + 1
+                let right = left + 1
+                if left < heap.count && before(heap[worst], heap[left]) { worst = left }
+                if right < heap.count && before(heap[worst], heap[right]) { worst = right }
+                if worst == p { return }
+                heap.swapAt(p, worst)
+                p = worst
+            }
+        }
+        func offer(_ i: Int) {
+            if heap.count < limit {
+                heap.append(i)
+                siftUp(heap.count - 1)
+            } else if before(i, heap[0]) {
+                rest.append(heap[0])
+                heap[0] = i
+                siftDown(0)
+            } else {
+                rest.append(i)
+            }
+        }
+        func canEnter(_ i: Int, _ ceiling: Double) -> Bool {
+            if heap.count < limit { return true }
+            let best = OrderWindow(state: facts[i].state, app: facts[i].app, searchMatches: true, searchRelevance: ceiling)
+            return precedes(best, i, facts[heap[0]], heap[0])
+        }
+        var pending = [(index: Int, ceiling: Double)]()
+        for i in facts.indices {
+            if let ceiling = ceilings[i] { pending.append((i, ceiling)) } else { offer(i) }
+        }
+        // the heap's worst only improves, so a window that can't enter now never will
+        while !pending.isEmpty {
+            var stillPending = [(index: Int, ceiling: Double)]()
+            for (i, ceiling) in pending {
+                guard canEnter(i, ceiling) else { rest.append(i); continue }
+                let rank = advance(i)
+                facts[i] = OrderWindow(state: facts[i].state, app: facts[i].app,
+                                       searchMatches: rank.relevance > 0, searchRelevance: rank.relevance)
+                if let ceiling = rank.ceiling { stillPending.append((i, ceiling)) } else { offer(i) }
+            }
+            pending = stillPending
+        }
+        rest.sort()
+        return (heap.sorted { before($0, $1) }, rest)
+    }
+
     static func compareByAppNameThenTitle(_ a: OrderWindow, _ b: OrderWindow) -> ComparisonResult {
         let order = (a.app.localizedName ?? "").localizedStandardCompare(b.app.localizedName ?? "")
         if order == .orderedSame {
@@ -6,7 +6,7 @@ import XCTest
 /// in, `Bool` out.
 ///
 /// Groups: A search ranking · B show-at-the-end buckets · C recentlyFocused · D recentlyCreated ·
-/// E alphabetical · F space · G tiebreak/symmetry.
+/// E alphabetical · F space · G tiebreak/symmetry · H ranked search prefix (+ benchmark).
 final class WindowOrderResolverTests: XCTestCase {
 
     private func w(searchMatches: Bool = false, searchRelevance: Double = 0,
@@ -149,4 +149,137 @@ final class WindowOrderResolverTests: XCTestCase {
         let a = w(lastFocusOrder: 3)
         XCTAssertFalse(WindowOrderResolver.isOrderedBefore(a, a, sortType: .recentlyFocused))
     }
+
+    // MARK: - H. Ranked search prefix
+
+    func testRankedPrefixMatchesStableSortPrefix() {
+        var rng = SeededGenerator(seed: 11)
+        let candidates = syntheticCandidates(300, &rng)
+        for query in ["c", "chr", "gthub", "tokyo shinkansen", "xyz", "kyto"] {
+            let q = SearchTestable.indexQuery(query)
+            let expected = fullySorted(candidates, q)
+            for limit in [1, 7, 64, 300, 1_000] {
+                let ranked = rankedPrefix(candidates, q, limit: limit)
+                XCTAssertEqual(ranked.prefix, Array(expected.prefix(limit)), "\(query) limit \(limit)")
+                XCTAssertEqual(ranked.rest, ranked.rest.sorted())
+                XCTAssertEqual(Set(ranked.prefix + ranked.rest), Set(candidates.indices))
+            }
+        }
+    }
+
+    func testRankedPrefixSkipsWindowsThatCantEnter() {
+        // 20 strong T3 app matches fill the heap; the 50 others can reach at most T4's cap, so they're never advanced
+        let strong: [Candidate] = (0..<20).map { (app: "Google Chrome", title: "Inbox \($0)") }
+        let weak: [Candidate] = (0..<50).map { (app: "Safari", title: "Kyoto \($0)") }
+        let candidates = strong + weak
+        var advanced = 0
+        let ranked = rankedPrefix(candidates, SearchTestable.indexQuery("chr"), limit: 10) { _ in advanced += 1 }
+        XCTAssertEqual(advanced, 0)
+        XCTAssertEqual(ranked.prefix, Array(fullySorted(candidates, SearchTestable.indexQuery("chr")).prefix(10)))
+    }
+
+    func testRankedPrefixAdvancesWindowsThatMightEnter() {
+        // fewer matches than the limit: every miss must be proven through T6
+        let candidates: [Candidate] = [(app: "Safari", title: "GitHub"), (app: "Xcode", title: "Kyoto"), (app: "Slack", title: "gthub notes")]
+        var advanced = 0
+        let ranked = rankedPrefix(candidates, SearchTestable.indexQuery("gthub"), limit: 3) { _ in advanced += 1 }
+        XCTAssertGreaterThan(advanced, 0)
+        XCTAssertEqual(ranked.prefix, fullySorted(candidates, SearchTestable.indexQuery("gthub")))
+    }
+
+    func testRankedPrefixEndingOnAMissLeavesNoMatchInTheRest() {
+        // `Windows` never scores such a rest: 3 matches, so the prefix of 10 ends on misses
+        let matches: [Candidate] = (0..<3).map { (app: "Safari", title: "GitHub \($0)") }
+        let misses: [Candidate] = (0..<100).map { (app: "Xcode", title: "Kyoto \($0)") }
+        let candidates = misses + matches
+        let q = SearchTestable.indexQuery("gthub")
+        let ranked = rankedPrefix(candidates, q, limit: 10)
+        XCTAssertEqual(fullRelevance(candidates[ranked.prefix.last!], q), 0)
+        XCTAssertFalse(ranked.rest.contains { fullRelevance(candidates[$0], q) > 0 })
+    }
+
+    func testRankedPrefixWithZeroLimitRanksNothing() {
+        let ranked = WindowOrderResolver.searchRankedPrefix([w(), w()], ceilings: [nil, 1], limit: 0) { _ in (0, nil) }
+        XCTAssertEqual(ranked.prefix, [])
+        XCTAssertEqual(ranked.rest, [0, 1])
+    }
+
+    func testBenchmarkFullSearchSort1k() {
+        var rng = SeededGenerator(seed: 5)
+        let candidates = syntheticCandidates(1_000, &rng)
+        measure { for query in ["s", "sh", "shi", "shin"] { _ = fullySorted(candidates, SearchTestable.indexQuery(query)) } }
+    }
+
+    func testBenchmarkRankedPrefix1k() {
+        var rng = SeededGenerator(seed: 5)
+        let candidates = syntheticCandidates(1_000, &rng)
+        measure { for query in ["s", "sh", "shi", "shin"] { _ = rankedPrefix(candidates, SearchTestable.indexQuery(query), limit: 64) } }
+    }
+
+    func testBenchmarkFullSearchSort5k() {
+        var rng = SeededGenerator(seed: 5)
+        let candidates = syntheticCandidates(5_000, &rng)
+        measure { for query in ["s", "sh", "shi", "shin"] { _ = fullySorted(candidates, SearchTestable.indexQuery(query)) } }
+    }
+
+    func testBenchmarkRankedPrefix5k() {
+        var rng = SeededGenerator(seed: 5)
+        let candidates = syntheticCandidates(5_000, &rng)
+        measure { for query in ["s", "sh", "shi", "shin"] { _ = rankedPrefix(candidates, SearchTestable.indexQuery(query), limit: 64) } }
+    }
+
+    private typealias Candidate = (app: String, title: String)
+
+    /// Mirrors `Windows.sortAll` in search mode: every window fully scored, then a stable sort
+    private func fullySorted(_ candidates: [Candidate], _ q: SearchTestable.Indexed) -> [Int] {
+        let facts = candidates.enumerated().map { i, c -> OrderWindow in
+            var staged = SearchTestable.StagedMatch()
+            while !staged.isComplete {
+                staged.advance(query: q, appName: SearchTestable.index(c.app), title: SearchTestable.index(c.title))
+            }
+            return w(searchMatches: staged.relevance > 0, searchRelevance: staged.relevance, lastFocusOrder: i % 17)
+        }
+        return facts.indices.sorted { i, j in
+            if WindowOrderResolver.isOrderedBefore(facts[i], facts[j], searchActive: true) { return true }
+            return !WindowOrderResolver.isOrderedBefore(facts[j], facts[i], searchActive: true) && i < j
+        }
+    }
+
+    private func fullRelevance(_ c: Candidate, _ q: SearchTestable.Indexed) -> Double {
+        var staged = SearchTestable.StagedMatch()
+        while !staged.isComplete {
+            staged.advance(query: q, appName: SearchTestable.index(c.app), title: SearchTestable.index(c.title))
+        }
+        return staged.relevance
+    }
+
+    /// Mirrors `Windows.rankSearchPrefix`: first tier band for everyone, later bands only on demand
+    private func rankedPrefix(_ candidates: [Candidate], _ q: SearchTestable.Indexed, limit: Int,
+                              onAdvance: (Int) -> Void = { _ in }) -> (prefix: [Int], rest: [Int]) {
+        let apps = candidates.map { SearchTestable.index($0.app) }
+        let titles = candidates.map { SearchTestable.index($0.title) }
+        var staged = candidates.map { _ in SearchTestable.StagedMatch() }
+        var ceilings = [Double?]()
+        let facts = candidates.indices.map { i -> OrderWindow in
+            staged[i].advance(query: q, appName: apps[i], title: titles[i])
+            ceilings.append(staged[i].ceiling)
+            return w(searchMatches: staged[i].relevance > 0, searchRelevance: staged[i].relevance, lastFocusOrder: i % 17)
+        }
+        let ranked = WindowOrderResolver.searchRankedPrefix(facts, ceilings: ceilings, limit: limit) { i in
+            onAdvance(i)
+            staged[i].advance(query: q, appName: apps[i], title: titles[i])
+            return (staged[i].relevance, staged[i].ceiling)
+        }
+        return ranked
+    }
+
+    private func syntheticCandidates(_ count: Int, _ rng: inout SeededGenerator) -> [Candidate] {
+        let apps = ["Safari", "Google Chrome", "Xcode", "Slack", "Terminal", "Finder", "Zoom", "Notes"]
+        let words = ["Tokyo", "Shinkansen", "Schedule", "GitHub", "Pull", "Request", "DevTools", "README.md", "Kyoto",
+                     "Inbox", "Build", "Succeeded", "Design", "System", "Meeting", "général", "Café", "2024"]
+        return (0..<count).map { _ in
+            (apps.randomElement(using: &rng)!,
+             (0..<Int.random(in: 2...8, using: &rng)).map { _ in words.randomElement(using: &rng)! }.joined(separator: " - "))
+        }
+    }
 }
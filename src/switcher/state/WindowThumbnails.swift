@@ -2,7 +2,59 @@ import Cocoa
 
 /// Off-main-thread screenshot capture for window thumbnails, plus the
 /// "preview the selected window" overlay shown next to the switcher panel.
+/// Captured thumbnails are held within a byte budget (see `ThumbnailBudget`); main thread only.
 enum WindowThumbnails {
+    private static var budget = ThumbnailBudget(budgetBytes: Preferences.thumbnailCacheBudgetBytes, reuseWindowNs: Preferences.thumbnailReuseWindowNs)
+    static var budgetStats: ThumbnailBudget.Stats { budget.stats }
+    static var budgetBytes: Int { budget.budgetBytes }
+
+    /// the preview panel draws the window at full size, so no shortcut previewing means thumbnails can be small
+    static var anyShortcutPreviewsSelectedWindow: Bool {
+        (0...Preferences.maxShortcutCount).contains { Preferences.effectivePreviewSelectedWindow($0) }
+    }
+
+    /// largest size (pixels) worth keeping a thumbnail at: the biggest tile any screen can draw. nil = keep full size
+    static func storageMaxSize() -> CGSize? {
+        let maxSize = TilesPanel.maxPossibleThumbnailSize
+        guard !anyShortcutPreviewsSelectedWindow, maxSize.width > 0, maxSize.height > 0 else { return nil }
+        return maxSize
+    }
+
+    /// a capture of `window` was just assigned: account for it, and drop the thumbnails it pushes over budget
+    static func didStore(_ window: Window, _ thumbnail: CALayerContents) {
+        guard let wid = window.cgWindowId else { return }
+        if budget.budgetBytes != Preferences.thumbnailCacheBudgetBytes {
+            drop(budget.setBudget(Preferences.thumbnailCacheBudgetBytes))
+        }
+        drop(budget.store(wid, bytes: thumbnail.byteCount(), nowNs: DispatchTime.now().uptimeNanoseconds))
+    }
+
+    /// tiles on screen are the most recently shown, and can't be evicted while they are
+    static func markShown(_ wids: Set<CGWindowID>) {
+        budget.markShown(wids)
+    }
+
+    /// the window moved, resized or retitled: its thumbnail is stale even if no capture follows (switcher hidden,
+    /// background capture off), so the next show retakes it instead of reusing it
+    static func markDirty(_ wids: [CGWindowID]) {
+        budget.markDirty(wids)
+    }
+
+    static func forget(_ wid: CGWindowID) {
+        budget.remove(wid)
+    }
+
+    private static func drop(_ wids: [CGWindowID]) {
+        guard !wids.isEmpty else { return }
+        for wid in wids {
+            Windows.byWindowId[wid]?.thumbnail = nil
+        }
+        let views = TilesView.recycledViews
+        for index in ThumbnailBudget.tilesHolding(wids, tileWids: views.map { $0.window_?.cgWindowId }) {
+            views[index].thumbnail.releaseImage()
+        }
+    }
+
     static func previewSelectedIfNeeded() {
         if let session = SwitcherSession.current, ScreenRecordingPermission.status == .granted
                && Preferences.effectivePreviewSelectedWindow(session.shortcutIndex)
@@ -20,14 +72,22 @@ enum WindowThumbnails {
 
     // dispatch screenshot requests off the main-thread, then wait for completion
     static func refreshAsync(_ windows: [Window], _ source: RefreshCausedBy, windowRemoved: Bool = false, prioritizedIds: Set<CGWindowID>? = nil) {
+        if source == .refreshUiAfterExternalEvent {
+            // these windows changed; if the capture below doesn't happen (or fails), the next show retakes them
+            budget.markDirty(windows.compactMap { $0.cgWindowId })
+        }
         let shortcutIndex = SwitcherSession.activeShortcutIndex
         guard (!windows.isEmpty || windowRemoved) && ScreenRecordingPermission.status == .granted
                && !ScreenLockEvents.isScreenLocked
                && (!Appearance.hideThumbnails || Preferences.effectivePreviewSelectedWindow(shortcutIndex))
                && (Preferences.captureWindowsInBackground || SwitcherSession.isActive) else { return }
         var eligibleWindows = [Window]()
+        budget.reuseWindowNs = Preferences.thumbnailReuseWindowNs
+        let nowNs = DispatchTime.now().uptimeNanoseconds
         for window in windows {
-            if !window.isWindowlessApp, let cgWindowId = window.cgWindowId, cgWindowId != CGWindowID(bitPattern: -1) {
+            if !window.isWindowlessApp, let cgWindowId = window.cgWindowId, cgWindowId != CGWindowID(bitPattern: -1),
+               // on show, only retake thumbnails that are missing, dirty, or old
+               source != .refreshOnlyThumbnailsAfterShowUi || budget.needsCapture(cgWindowId, nowNs: nowNs) {
                 eligibleWindows.append(window)
             }
         }
@@ -23,12 +23,29 @@ class Windows {
     /// consumes this to record the tab Space-less at discovery. Cleared if the wid is re-added to a Space, or
     /// on destroy/removal.
     static var windowsPendingSpaceRemoval = Set<CGWindowID>()
+    /// What a search `sort` left past its ranked prefix; the prefix is the windows stamped with `rankingGeneration`
+    private static var searchTail = SearchTail.none
+    /// The last shown tile of the ranked prefix; the selection or the viewport reaching it reveals the tail
+    private static var lastRankedIndex = 0
+    /// Bumped by each `sort`, so a prefix's stamps (`Window.searchPrefixGeneration`) never outlive it
+    private static var rankingGeneration = 0
     private static var lastWindowActivityType = WindowActivityType.none
     private static var shouldSelectBestMatchOnSearchChange = false
     private static var shouldRestoreDefaultSelectionOnSearchClear = false
 
+    private enum SearchTail {
+        /// every window is ordered
+        case none
+        /// not ordered yet, so hidden until `rankTail`; windows added since the sort are part of it
+        case hidden
+        /// the prefix ends on a miss, so nothing after it can match: it stays hidden without being scored
+        case unmatched
+    }
+
     static func shouldDisplay(_ window: Window) -> Bool {
-        window.shouldShowTheUser && Search.matches(window, query: (SwitcherSession.current?.searchQuery ?? ""))
+        window.shouldShowTheUser
+            && (searchTail == .none || window.searchPrefixGeneration == rankingGeneration)
+            && Search.matches(window, query: (SwitcherSession.current?.searchQuery ?? ""))
     }
 
     static func updateSearchQuery(_ query: String) {
@@ -42,6 +59,7 @@ class Windows {
             return
         }
         if previousTrimmedQuery != newTrimmedQuery {
+            session.searchTailRevealed = false
             if newTrimmedQuery.isEmpty {
                 shouldRestoreDefaultSelectionOnSearchClear = !previousTrimmedQuery.isEmpty
                 shouldSelectBestMatchOnSearchChange = false
@@ -62,6 +80,19 @@ class Windows {
         Applications.updateWindowStatesViaWindowServer(wids)
     }
 
+    /// What the user is looking at changed: AX reads for on-screen, selected and hovered tiles jump their lane's
+    /// queue, and on-screen thumbnails become the most recently shown (last to be evicted)
+    static func visibleTilesChanged() {
+        var wids = TilesView.windowIdsInViewport()
+        WindowThumbnails.markShown(wids)
+        if let session = SwitcherSession.current {
+            for index in [session.selectedIndex, session.hoveredIndex].compactMap({ $0 }) where index >= 0 && index < list.count {
+                if let wid = list[index].cgWindowId { wids.insert(wid) }
+            }
+        }
+        AXCallScheduler.shared.boost(wids)
+    }
+
     static func voiceOverWindow(_ windowIndex: Int = (SwitcherSession.current?.selectedIndex ?? 0)) {
         guard SwitcherSession.isActive && TilesPanel.shared.isKeyWindow else { return }
         if TilesView.isSearchEditing { return }
@@ -282,13 +313,19 @@ class Windows {
         TilesView.highlight(index)
         let focusedView = TilesView.recycledViews[index]
         TilesView.scrollView.contentView.scrollToVisible(focusedView.frame)
+        visibleTilesChanged()
         voiceOverWindow(index)
     }
 
     static func cycleSelectedWindowIndex(_ step: Int, allowWrap: Bool = true) {
         guard let session = SwitcherSession.current else { return }
         guard list.contains(where: { shouldDisplay($0) }) else { return }
-        let nextIndex = selectedWindowIndexAfterCycling(step)
+        var nextIndex = selectedWindowIndexAfterCycling(step)
+        if searchTail == .hidden && (nextIndex >= lastRankedIndex
+            || (step > 0 && nextIndex < session.selectedIndex) || (step < 0 && nextIndex > session.selectedIndex)) {
+            rankTail()
+            nextIndex = selectedWindowIndexAfterCycling(step)
+        }
         // don't wrap-around at the end, if key-repeat
         if (((step > 0 && nextIndex < session.selectedIndex) || (step < 0 && nextIndex > session.selectedIndex)) &&
             (!allowWrap || ATShortcut.lastEventIsARepeat || !KeyRepeatTimer.timerIsSuspended))
@@ -340,17 +377,33 @@ class Windows {
 
     /// reordered list based on preferences, keeping the original index
     private static func sort() {
-        let trimmedQuery = Search.normalizedQuery((SwitcherSession.current?.searchQuery ?? ""))
+        searchTail = .none
+        rankingGeneration += 1
+        // `Search` is always given the raw query, so it indexes it once per keystroke
+        let query = SwitcherSession.current?.searchQuery ?? ""
+        // While searching, only the first screenful needs ranking before the UI shows; see `rankSearchPrefix`.
+        // Once the user reached the tail, re-sorts after external events keep it in place for the rest of the query.
+        if !Search.normalizedQuery(query).isEmpty, let session = SwitcherSession.current, !session.searchTailRevealed {
+            let limit = max(64, TilesView.tilesPerScreenful())
+            if list.count > limit {
+                rankSearchPrefix(query, limit)
+                return
+            }
+        }
+        sortAll(query)
+    }
+
+    private static func sortAll(_ query: String) {
         let shortcutIndex = (SwitcherSession.current?.shortcutIndex ?? 0)
         // Hoisted once per sort: locals are captured by the comparator closure so each of the
         // O(n log n) comparisons reads them directly.
-        let searchActive = !trimmedQuery.isEmpty
+        let searchActive = !Search.normalizedQuery(query).isEmpty
         let windowlessAtEnd = Preferences.showWindowlessApps(shortcutIndex) == .showAtTheEnd
         let hiddenAtEnd = Preferences.showHiddenWindows(shortcutIndex) == .showAtTheEnd
         let minimizedAtEnd = Preferences.showMinimizedWindows(shortcutIndex) == .showAtTheEnd
         let sortType = orderSortType(Preferences.windowOrder(shortcutIndex))
         // Precompute each window's ordering facts once (O(n) Search calls), then sort on the snapshots.
-        let facts = Dictionary(uniqueKeysWithValues: list.map { (ObjectIdentifier($0), orderWindow($0, trimmedQuery)) })
+        let facts = Dictionary(uniqueKeysWithValues: list.map { (ObjectIdentifier($0), orderWindow($0, query, searchActive)) })
         list.sort {
             WindowOrderResolver.isOrderedBefore(
                 facts[ObjectIdentifier($0)]!, facts[ObjectIdentifier($1)]!,
@@ -362,12 +415,69 @@ class Windows {
         }
     }
 
-    private static func orderWindow(_ window: Window, _ query: String) -> OrderWindow {
+    /// Ranks only the windows that can reach the first `limit` search results, skipping the T5/T6 work of the
+    /// rest (`WindowOrderResolver.searchRankedPrefix`). The visible prefix is exactly what `sortAll` gives;
+    /// the tail stays hidden until scrolling or the selection reaches the prefix's end (`rankTail`).
+    private static func rankSearchPrefix(_ query: String, _ limit: Int) {
+        let windows = list
+        var ceilings = [Double?]()
+        ceilings.reserveCapacity(windows.count)
+        let facts = windows.map { window -> OrderWindow in
+            let rank = Search.stagedRank(for: window, query: query)
+            ceilings.append(rank.ceiling)
+            return OrderWindow(state: window.state, app: window.application.state,
+                               searchMatches: rank.relevance > 0, searchRelevance: rank.relevance)
+        }
+        let ranked = WindowOrderResolver.searchRankedPrefix(facts, ceilings: ceilings, limit: limit) {
+            Search.advanceRank(for: windows[$0], query: query)
+        }
+        list = ranked.prefix.map { windows[$0] } + ranked.rest.map { windows[$0] }
+        guard !ranked.rest.isEmpty else { return }
+        for i in ranked.prefix {
+            windows[i].searchPrefixGeneration = rankingGeneration
+        }
+        // matches order first, so a match in the rest would have displaced the prefix's last miss
+        guard Search.matches(list[ranked.prefix.count - 1], query: query) else {
+            searchTail = .unmatched
+            return
+        }
+        searchTail = .hidden
+        guard let lastShown = list[..<ranked.prefix.count].lastIndex(where: { shouldDisplay($0) }) else {
+            // nothing in the prefix shows, so there's no end of it to reach
+            searchTail = .none
+            sortAll(query)
+            return
+        }
+        lastRankedIndex = lastShown
+    }
+
+    /// Scrolling brought the end of the ranked prefix on screen
+    static func viewportScrolled() {
+        guard searchTail == .hidden && TilesView.isTileInViewport(lastRankedIndex) else { return }
+        rankTail()
+    }
+
+    /// Reveals the tail `rankSearchPrefix` hid, if any, scoring it now. Only a tail with matches needs ordering and
+    /// laying out; the prefix is already in place, so only the tail moves. A `.unmatched` tail has nothing to reveal.
+    static func rankTail() {
+        guard searchTail == .hidden, let session = SwitcherSession.current else { return }
+        searchTail = .none
+        session.searchTailRevealed = true
+        let query = session.searchQuery
+        let tailMatches = list.contains {
+            $0.searchPrefixGeneration != rankingGeneration && $0.shouldShowTheUser && Search.matches($0, query: query)
+        }
+        guard tailMatches else { return }
+        sortAll(query)
+        App.refreshUi(true)
+    }
+
+    private static func orderWindow(_ window: Window, _ query: String, _ searchActive: Bool) -> OrderWindow {
         OrderWindow(
             state: window.state,
             app: window.application.state,
-            searchMatches: query.isEmpty ? false : Search.matches(window, query: query),
-            searchRelevance: query.isEmpty ? 0 : Search.relevance(for: window, query: query))
+            searchMatches: searchActive ? Search.matches(window, query: query) : false,
+            searchRelevance: searchActive ? Search.relevance(for: window, query: query) : 0)
     }
 
     private static func orderSortType(_ p: WindowOrderPreference) -> OrderSortType {
@@ -478,6 +588,7 @@ class Windows {
                 windowsPendingFocusPromotion.remove(wid)
                 recentlyCreatedWindows.remove(wid)
                 WindowServerEvents.unsubscribe(wid)
+                WindowThumbnails.forget(wid)
             }
         }
         let toRemove = windows.map { $0.lastFocusOrder }
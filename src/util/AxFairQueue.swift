@@ -0,0 +1,218 @@
+import Cocoa
+
+/// The waiting room of one `AXCallScheduler` lane: which queued AX call a freed worker runs next. Pure (no
+/// clocks, queues or locks — the owner holds its lock around every call), so fairness and cancellation are
+/// unit-testable (same pattern as `SchedulingPolicy`).
+///
+/// - **Fair across apps**: deficit round-robin over per-pid flows. Each turn a flow earns `quantumMs` and
+///   runs calls while it can pay their cost, so one app with 150 queued windows gets the same share as an
+///   app with one, and an app whose calls are slow (see `AxCallCost`) gets fewer of them per turn.
+/// - **Boosted first**: calls for windows the user is looking at (`setBoosted`) are served before the rest,
+///   still fairly among themselves.
+/// - **Cancellable**: `removeAll(where:)` drops queued calls that became pointless (closed window, ended
+///   switcher session) and hands them back so the owner can release their per-key state.
+/// FIFO within a flow; calls are never reordered inside one app.
+struct AxFairQueue<Job> {
+    static var quantumMs: Int { 8 }
+
+    struct Entry {
+        let job: Job
+        let key: String
+        let pid: pid_t?
+        let costMs: Int
+        let sessionScoped: Bool
+        fileprivate let seq: Int
+        /// `wid-<N>-…` keys are per-window calls; others (`pid-…`, `badges`) aren't boostable
+        var wid: CGWindowID? { AxFairQueue.wid(fromKey: key) }
+    }
+
+    struct Stats: Equatable {
+        var queued = 0
+        var boostedQueued = 0
+        var flows = 0
+        var peakQueued = 0
+        var served = 0
+        var dropped = 0
+    }
+
+    private(set) var stats = Stats()
+    private var boosted = Drr()
+    private var normal = Drr()
+    private var boostedWids = Set<CGWindowID>()
+    private var nextSeq = 0
+
+    var isEmpty: Bool { boosted.count + normal.count == 0 }
+    var count: Int { boosted.count + normal.count }
+
+    mutating func enqueue(_ job: Job, key: String, pid: pid_t?, costMs: Int = 1, sessionScoped: Bool = false) {
+        let entry = Entry(job: job, key: key, pid: pid, costMs: max(1, costMs), sessionScoped: sessionScoped, seq: nextSeq)
+        nextSeq += 1
+        if isBoosted(entry) { boosted.push(entry) } else { normal.push(entry) }
+        refreshStats()
+        stats.peakQueued = max(stats.peakQueued, stats.queued)
+    }
+
+    mutating func dequeue() -> Entry? {
+        guard let entry = boosted.pop() ?? normal.pop() else { return nil }
+        stats.served += 1
+        refreshStats()
+        return entry
+    }
+
+    /// Replace the set of windows whose calls jump the queue; already-queued calls move class, keeping order
+    mutating func setBoosted(_ wids: Set<CGWindowID>) {
+        guard wids != boostedWids else { return }
+        boostedWids = wids
+        let all = boosted.drain() + normal.drain()
+        for entry in all.sorted(by: { $0.seq < $1.seq }) {
+            if isBoosted(entry) { boosted.push(entry) } else { normal.push(entry) }
+        }
+        refreshStats()
+    }
+
+    /// Drop queued calls matching `predicate`; returns them, oldest first
+    @discardableResult
+    mutating func removeAll(where predicate: (Entry) -> Bool) -> [Entry] {
+        let removed = (boosted.remove(where: predicate) + normal.remove(where: predicate)).sorted { $0.seq < $1.seq }
+        stats.dropped += removed.count
+        refreshStats()
+        return removed
+    }
+
+    static func wid(fromKey key: String) -> CGWindowID? {
+        guard key.hasPrefix("wid-") else { return nil }
+        return CGWindowID(key.dropFirst(4).prefix { $0.isNumber })
+    }
+
+    private func isBoosted(_ entry: Entry) -> Bool {
+        guard !boostedWids.isEmpty, let wid = entry.wid else { return false }
+        return boostedWids.contains(wid)
+    }
+
+    private mutating func refreshStats() {
+        stats.queued = count
+        stats.boostedQueued = boosted.count
+        stats.flows = boosted.flowCount + normal.flowCount
+    }
+
+    /// One deficit-round-robin class: a ring of pids with queued calls, each with its own FIFO and deficit
+    private struct Drr {
+        private struct Flow {
+            var entries = [Entry]()
+            var head = 0
+            var deficit = 0
+            var isEmpty: Bool { head == entries.count }
+        }
+
+        private var flows = [pid_t: Flow]()
+        private var ring = [pid_t]()
+        private var cursor = 0
+        private var turnStarted = false
+        private(set) var count = 0
+        var flowCount: Int { ring.count }
+
+        mutating func push(_ entry: Entry) {
+            let pid = entry.pid ?? 0
+            if flows[pid] == nil {
+                flows[pid] = Flow()
+                // join at the back of the round: behind every flow already waiting for its turn
+                ring.insert(pid, at: cursor)
+                if ring.count > 1 { cursor += 1 }
+            }
+            flows[pid]!.entries.append(entry)
+            count += 1
+        }
+
+        mutating func pop() -> Entry? {
+            while !ring.isEmpty {
+                let pid = ring[cursor]
+                var flow = flows[pid]!
+                if !turnStarted {
+                    flow.deficit += AxFairQueue.quantumMs
+                    turnStarted = true
+                }
+                let head = flow.entries[flow.head]
+                if head.costMs <= flow.deficit {
+                    flow.deficit -= head.costMs
+                    flow.head += 1
+                    count -= 1
+                    if flow.isEmpty {
+                        removeFlow(at: cursor)
+                    } else {
+                        // compact once the consumed prefix dominates, so long FIFOs stay O(1) amortized
+                        if flow.head > 32 && flow.head * 2 > flow.entries.count {
+                            flow.entries.removeFirst(flow.head)
+                            flow.head = 0
+                        }
+                        flows[pid] = flow
+                    }
+                    return head
+                }
+                flows[pid] = flow
+                cursor = (cursor + 1) % ring.count
+                turnStarted = false
+            }
+            return nil
+        }
+
+        mutating func remove(where predicate: (Entry) -> Bool) -> [Entry] {
+            var removed = [Entry]()
+            for pid in ring {
+                var flow = flows[pid]!
+                let live = flow.entries[flow.head...]
+                let kept = live.filter { !predicate($0) }
+                guard kept.count != live.count else { continue }
+                removed += live.filter { predicate($0) }
+                flow.entries = Array(kept)
+                flow.head = 0
+                flows[pid] = flow
+            }
+            count -= removed.count
+            for index in ring.indices.reversed() where flows[ring[index]]!.isEmpty {
+                removeFlow(at: index)
+            }
+            return removed
+        }
+
+        mutating func drain() -> [Entry] {
+            let all = ring.flatMap { flows[$0]!.entries[flows[$0]!.head...] }
+            self = Drr()
+            return all
+        }
+
+        private mutating func removeFlow(at index: Int) {
+            flows[ring[index]] = nil
+            ring.remove(at: index)
+            if index < cursor {
+                cursor -= 1
+            } else if index == cursor {
+                // the flow being served left: its successor (now at `cursor`) starts a fresh turn
+                turnStarted = false
+                if cursor == ring.count { cursor = 0 }
+            }
+        }
+    }
+}
+
+/// Per-app cost estimate fed to `AxFairQueue`: an exponential moving average of how long that app's AX
+/// calls held a worker, in whole ms (at least 1). Slow apps cost more per call, so DRR gives them fewer
+/// calls per round instead of letting them hold every worker.
+struct AxCallCost {
+    static let maxCostMs = 1_000 // the AX messaging timeout: a call can't hold a worker longer
+    private var emaMs = [pid_t: Double]()
+
+    mutating func record(pid: pid_t?, durationNs: UInt64) {
+        guard let pid else { return }
+        let ms = min(Double(durationNs) / 1_000_000, Double(Self.maxCostMs))
+        emaMs[pid] = emaMs[pid].map { $0 * 0.75 + ms * 0.25 } ?? ms
+    }
+
+    func costMs(pid: pid_t?) -> Int {
+        guard let pid, let ms = emaMs[pid] else { return 1 }
+        return min(max(1, Int(ms.rounded())), Self.maxCostMs)
+    }
+
+    mutating func forget(pid: pid_t) {
+        emaMs[pid] = nil
+    }
+}
@@ -0,0 +1,192 @@
+import XCTest
+
+/// Pins the order in which a lane's queued AX calls run: round-robin across apps weighted by their cost,
+/// boosted windows first, FIFO within an app, and dropped calls never running. `AXCallScheduler` only
+/// pops this queue, so keeping these green keeps the lane fair.
+final class AxFairQueueTests: XCTestCase {
+    private typealias Queue = AxFairQueue<Int>
+
+    private func drainKeys(_ queue: inout Queue, _ limit: Int = .max) -> [String] {
+        var keys = [String]()
+        while keys.count < limit, let entry = queue.dequeue() { keys.append(entry.key) }
+        return keys
+    }
+
+    private func drainPids(_ queue: inout Queue, _ limit: Int = .max) -> [pid_t?] {
+        var pids = [pid_t?]()
+        while pids.count < limit, let entry = queue.dequeue() { pids.append(entry.pid) }
+        return pids
+    }
+
+    // MARK: - A. Fairness
+
+    func testFifoWithinOneApp() {
+        var queue = Queue()
+        for wid in 1...5 { queue.enqueue(wid, key: "wid-\(wid)-generic", pid: 1) }
+        XCTAssertEqual(drainKeys(&queue), (1...5).map { "wid-\($0)-generic" })
+    }
+
+    func testBigAppCantStarveAnotherApp() {
+        var queue = Queue()
+        for wid in 1...150 { queue.enqueue(wid, key: "wid-\(wid)-acquire", pid: 1) }
+        queue.enqueue(0, key: "wid-999-focus", pid: 2)
+        let order = drainKeys(&queue)
+        XCTAssertEqual(order.firstIndex(of: "wid-999-focus"), Queue.quantumMs, "waits one turn of the big app, not 150 calls")
+    }
+
+    func testAppsAlternateTurns() {
+        var queue = Queue()
+        for i in 0..<30 {
+            queue.enqueue(i, key: "a\(i)", pid: 1)
+            queue.enqueue(i, key: "b\(i)", pid: 2)
+        }
+        let pids = drainPids(&queue)
+        XCTAssertEqual(pids.prefix(8).filter { $0 == 1 }.count, 8)
+        XCTAssertEqual(pids[8..<16].filter { $0 == 2 }.count, 8)
+        XCTAssertEqual(pids[16..<24].filter { $0 == 1 }.count, 8)
+    }
+
+    func testSlowAppGetsFewerCallsPerTurn() {
+        var queue = Queue()
+        for i in 0..<20 {
+            queue.enqueue(i, key: "slow\(i)", pid: 1, costMs: 4)
+            queue.enqueue(i, key: "fast\(i)", pid: 2, costMs: 1)
+        }
+        let pids = drainPids(&queue, 10)
+        XCTAssertEqual(pids.filter { $0 == 1 }.count, 2, "a turn pays for 8ms: two 4ms calls")
+        XCTAssertEqual(pids.filter { $0 == 2 }.count, 8)
+    }
+
+    func testCallCostingMoreThanAQuantumStillRuns() {
+        var queue = Queue()
+        queue.enqueue(0, key: "slow", pid: 1, costMs: 100)
+        XCTAssertEqual(queue.dequeue()?.key, "slow")
+        XCTAssertNil(queue.dequeue())
+    }
+
+    func testCallsWithoutPidShareOneFlow() {
+        var queue = Queue()
+        queue.enqueue(0, key: "badges", pid: nil)
+        queue.enqueue(1, key: "other", pid: nil)
+        XCTAssertEqual(queue.stats.flows, 1)
+        XCTAssertEqual(drainKeys(&queue), ["badges", "other"])
+    }
+
+    // MARK: - B. Boost
+
+    func testBoostedWindowsRunFirst() {
+        var queue = Queue()
+        for wid in 1...5 { queue.enqueue(wid, key: "wid-\(wid)-generic", pid: 1) }
+        queue.setBoosted([4])
+        XCTAssertEqual(drainKeys(&queue), ["wid-4-generic", "wid-1-generic", "wid-2-generic", "wid-3-generic", "wid-5-generic"])
+    }
+
+    func testBoostAppliesToLaterCalls() {
+        var queue = Queue()
+        queue.setBoosted([9])
+        queue.enqueue(1, key: "wid-1-generic", pid: 1)
+        queue.enqueue(9, key: "wid-9-generic", pid: 2)
+        XCTAssertEqual(queue.stats.boostedQueued, 1)
+        XCTAssertEqual(drainKeys(&queue), ["wid-9-generic", "wid-1-generic"])
+    }
+
+    func testUnboostingRestoresFifo() {
+        var queue = Queue()
+        for wid in 1...3 { queue.enqueue(wid, key: "wid-\(wid)-generic", pid: 1) }
+        queue.setBoosted([3])
+        queue.setBoosted([])
+        XCTAssertEqual(drainKeys(&queue), ["wid-1-generic", "wid-2-generic", "wid-3-generic"])
+    }
+
+    func testOnlyWindowKeysAreBoostable() {
+        XCTAssertEqual(Queue.wid(fromKey: "wid-42-generic"), 42)
+        XCTAssertEqual(Queue.wid(fromKey: "wid-7-acquire"), 7)
+        XCTAssertNil(Queue.wid(fromKey: "pid-42-tabadopt"))
+        XCTAssertNil(Queue.wid(fromKey: "badges"))
+        XCTAssertNil(Queue.wid(fromKey: "wid--x"))
+        var queue = Queue()
+        queue.setBoosted([42])
+        queue.enqueue(0, key: "pid-42-tabadopt", pid: 42)
+        XCTAssertEqual(queue.stats.boostedQueued, 0)
+    }
+
+    // MARK: - C. Cancellation
+
+    func testClosedWindowCallsAreDropped() {
+        var queue = Queue()
+        queue.enqueue(0, key: "wid-1-generic", pid: 1)
+        queue.enqueue(1, key: "wid-2-acquire", pid: 1)
+        queue.enqueue(2, key: "wid-2-generic", pid: 2)
+        queue.enqueue(3, key: "wid-3-generic", pid: 2)
+        let dropped = queue.removeAll { $0.key.hasPrefix("wid-2-") }
+        XCTAssertEqual(dropped.map { $0.key }, ["wid-2-acquire", "wid-2-generic"])
+        XCTAssertEqual(queue.stats.dropped, 2)
+        XCTAssertEqual(drainKeys(&queue), ["wid-1-generic", "wid-3-generic"])
+    }
+
+    func testEndedSessionCallsAreDropped() {
+        var queue = Queue()
+        queue.enqueue(0, key: "badges", pid: 5, sessionScoped: true)
+        queue.enqueue(1, key: "wid-1-generic", pid: 1, sessionScoped: true)
+        queue.enqueue(2, key: "wid-1-liveness", pid: 1)
+        XCTAssertEqual(queue.removeAll { $0.sessionScoped }.count, 2)
+        XCTAssertEqual(drainKeys(&queue), ["wid-1-liveness"])
+    }
+
+    func testDroppingTheAppBeingServedHandsTheTurnOn() {
+        var queue = Queue()
+        for i in 0..<10 {
+            queue.enqueue(i, key: "a\(i)", pid: 1)
+            queue.enqueue(i, key: "b\(i)", pid: 2)
+        }
+        XCTAssertEqual(queue.dequeue()?.pid, 1)
+        queue.removeAll { $0.pid == 1 }
+        XCTAssertEqual(drainPids(&queue), Array(repeating: 2, count: 10))
+        queue.enqueue(0, key: "a-again", pid: 1)
+        XCTAssertEqual(drainKeys(&queue), ["a-again"])
+    }
+
+    // MARK: - D. Stats
+
+    func testStatsTrackQueuedPeakServedAndFlows() {
+        var queue = Queue()
+        for i in 0..<4 { queue.enqueue(i, key: "wid-\(i)-generic", pid: pid_t(i % 2)) }
+        XCTAssertEqual(queue.stats, .init(queued: 4, boostedQueued: 0, flows: 2, peakQueued: 4, served: 0, dropped: 0))
+        _ = queue.dequeue()
+        queue.removeAll { $0.key == "wid-3-generic" }
+        XCTAssertEqual(queue.stats, .init(queued: 2, boostedQueued: 0, flows: 2, peakQueued: 4, served: 1, dropped: 1))
+    }
+
+    // MARK: - E. AxCallCost
+
+    func testCostFollowsTheAppsRecentDurations() {
+        var cost = AxCallCost()
+        XCTAssertEqual(cost.costMs(pid: 1), 1, "unknown app: the minimum")
+        XCTAssertEqual(cost.costMs(pid: nil), 1)
+        cost.record(pid: 1, durationNs: 40_000_000)
+        XCTAssertEqual(cost.costMs(pid: 1), 40)
+        cost.record(pid: 1, durationNs: 0)
+        XCTAssertEqual(cost.costMs(pid: 1), 30, "moving average, 1/4 weight on the newest")
+        cost.record(pid: 2, durationNs: 100)
+        XCTAssertEqual(cost.costMs(pid: 2), 1, "sub-ms calls still cost 1")
+        cost.forget(pid: 1)
+        XCTAssertEqual(cost.costMs(pid: 1), 1)
+    }
+
+    func testCostIsCappedAtTheMessagingTimeout() {
+        var cost = AxCallCost()
+        cost.record(pid: 1, durationNs: 30_000_000_000)
+        XCTAssertEqual(cost.costMs(pid: 1), AxCallCost.maxCostMs)
+    }
+
+    // MARK: - F. Benchmark
+
+    func testBenchmarkFairQueue10kCallsAcross60Apps() {
+        measure {
+            var queue = Queue()
+            for i in 0..<10_000 { queue.enqueue(i, key: "wid-\(i)-generic", pid: pid_t(i % 60), costMs: 1 + i % 5) }
+            queue.setBoosted(Set((0..<50).map { CGWindowID($0 * 7) }))
+            while queue.dequeue() != nil {}
+        }
+    }
+}
@@ -34,3 +34,70 @@ enum RetryPolicy {
         elapsedSinceStartNs >= giveUpAfterNs
     }
 }
+
+/// The per-key in-flight state machine of `AXCallScheduler`: one call per key at a time. A call scheduled
+/// while one is in flight is held (a newer one replaces it) and runs when the current one ends; held while
+/// the current one is retrying, it also cancels those retries. `WsEventReplay` drives the same machine on its
+/// virtual clock. `Call` is whatever the owner needs to submit a held call later; the owner keeps the lock.
+struct AxCallKeyState<Call> {
+    enum Phase: Equatable {
+        case idle
+        case executing
+        case retrying
+    }
+
+    enum Scheduled {
+        case submit                // the key was idle: submit the call now
+        case held(replaced: Call?) // a call is in flight: this one waits, replacing the call held before it
+    }
+
+    enum AttemptOutcome: Equatable {
+        case succeeded
+        case gaveUp
+        case retry(delayNs: UInt64)
+    }
+
+    private(set) var phase = Phase.idle
+    private(set) var retryCount = 0
+    private(set) var heldCall: Call?
+    /// a call was held while retrying: the next attempt must not run; `next()` takes over instead
+    private(set) var cancelRetries = false
+
+    mutating func schedule(_ call: Call) -> Scheduled {
+        guard phase != .idle else {
+            phase = .executing
+            return .submit
+        }
+        let replaced = heldCall
+        heldCall = call
+        if phase == .retrying { cancelRetries = true }
+        return .held(replaced: replaced)
+    }
+
+    /// The attempt returned. `elapsedSinceStartNs` is measured from the first attempt of the current call.
+    mutating func attemptEnded(succeeded: Bool, elapsedSinceStartNs: UInt64) -> AttemptOutcome {
+        if succeeded || RetryPolicy.shouldGiveUp(elapsedSinceStartNs: elapsedSinceStartNs) {
+            phase = .idle
+            cancelRetries = false
+            retryCount = 0
+            return succeeded ? .succeeded : .gaveUp
+        }
+        phase = .retrying
+        let delayNs = RetryPolicy.backoffDelayNs(retryCount: retryCount)
+        retryCount += 1
+        return .retry(delayNs: delayNs)
+    }
+
+    /// The current call is over (ended, or cancelled by a held call): the held call to submit now, if any.
+    /// A cancelled chain's retry count carries over to the call replacing it.
+    mutating func next() -> Call? {
+        cancelRetries = false
+        guard let call = heldCall else {
+            phase = .idle
+            return nil
+        }
+        heldCall = nil
+        phase = .executing
+        return call
+    }
+}
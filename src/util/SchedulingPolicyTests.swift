@@ -1,7 +1,7 @@
 import XCTest
 
-/// Pins the pure timing decisions of the AX scheduling layer — coalescing (leading + trailing + drop) and
-/// retry backoff/give-up — deterministically, with no clocks or queues. The owners (`Throttler`,
+/// Pins the pure timing decisions of the AX scheduling layer — coalescing (leading + trailing + drop),
+/// retry backoff/give-up and the per-key in-flight state — deterministically, with no clocks or queues. The owners (`Throttler`,
 /// `ThrottlerWithKey`, `AXCallScheduler`) branch on these, so keeping them green keeps that behavior fixed.
 final class SchedulingPolicyTests: XCTestCase {
 
@@ -60,4 +60,52 @@ final class SchedulingPolicyTests: XCTestCase {
         XCTAssertFalse(RetryPolicy.shouldGiveUp(elapsedSinceStartNs: 0))
         XCTAssertFalse(RetryPolicy.shouldGiveUp(elapsedSinceStartNs: 59_999_999_999))
     }
+
+    // MARK: - C. AxCallKeyState
+
+    func testIdleKeySubmitsAndBusyKeyHoldsTheLatestCall() {
+        var key = AxCallKeyState<Int>()
+        guard case .submit = key.schedule(1) else { return XCTFail() }
+        guard case .held(nil) = key.schedule(2) else { return XCTFail() }
+        guard case .held(2?) = key.schedule(3) else { return XCTFail("the newer call replaces the held one") }
+        XCTAssertEqual(key.phase, .executing)
+        XCTAssertFalse(key.cancelRetries, "holding while executing doesn't cancel anything")
+    }
+
+    func testEndedCallRunsTheHeldOneThenGoesIdle() {
+        var key = AxCallKeyState<Int>()
+        _ = key.schedule(1)
+        _ = key.schedule(2)
+        XCTAssertEqual(key.attemptEnded(succeeded: true, elapsedSinceStartNs: 0), .succeeded)
+        XCTAssertEqual(key.next(), 2)
+        XCTAssertEqual(key.phase, .executing)
+        XCTAssertEqual(key.attemptEnded(succeeded: true, elapsedSinceStartNs: 0), .succeeded)
+        XCTAssertNil(key.next())
+        XCTAssertEqual(key.phase, .idle)
+    }
+
+    func testFailedAttemptsRetryWithBackoffUntilTheyGiveUp() {
+        var key = AxCallKeyState<Int>()
+        _ = key.schedule(1)
+        XCTAssertEqual(key.attemptEnded(succeeded: false, elapsedSinceStartNs: 0), .retry(delayNs: 200_000_000))
+        XCTAssertEqual(key.attemptEnded(succeeded: false, elapsedSinceStartNs: 1), .retry(delayNs: 1_000_000_000))
+        XCTAssertEqual(key.phase, .retrying)
+        XCTAssertEqual(key.attemptEnded(succeeded: false, elapsedSinceStartNs: RetryPolicy.giveUpAfterNs), .gaveUp)
+        XCTAssertEqual(key.phase, .idle)
+        XCTAssertEqual(key.retryCount, 0)
+    }
+
+    func testCallHeldWhileRetryingCancelsTheRetries() {
+        var key = AxCallKeyState<Int>()
+        _ = key.schedule(1)
+        _ = key.attemptEnded(succeeded: false, elapsedSinceStartNs: 0)
+        _ = key.schedule(2)
+        XCTAssertTrue(key.cancelRetries)
+        // the retry attempt sees the cancel and hands over instead of running
+        XCTAssertEqual(key.next(), 2)
+        XCTAssertFalse(key.cancelRetries)
+        XCTAssertEqual(key.phase, .executing)
+        XCTAssertEqual(key.attemptEnded(succeeded: false, elapsedSinceStartNs: 0), .retry(delayNs: 1_000_000_000),
+                       "the replacing call continues the cancelled chain's backoff")
+    }
 }
@@ -0,0 +1,100 @@
+import Foundation
+
+/// The on-disk format and index behind `UsageStats`. Each key is an append-only column file: a fixed header,
+/// then one fixed-size record per event (its Unix time as `Int64`), in append order. `UsageStats` maps the
+/// column read-only and appends with `write(2)`, so recording an event costs one 8-byte write instead of
+/// re-serializing the key's whole array. Pure (no files, clock or mapping — the caller passes bytes, columns
+/// and times), so the format, the day buckets and compaction are unit-testable.
+///
+/// - **Columns are ascending**: `appendable` clamps a timestamp that went back in time (clock change) to the
+///   last one, so every column stays sorted and binary-searchable.
+/// - **Day buckets**: `DayIndex` keeps where each UTC day starts in the column; `count(since:)` is a
+///   subtraction plus a binary search within one day's records.
+/// - **Compaction** keeps the records from `compactionStart` on; `UsageStats` rewrites the file with them.
+enum UsageLog {
+    static let magic: [UInt8] = Array("ATUS".utf8)
+    static let version: UInt8 = 1
+    static let headerSize = 16
+    static let recordSize = MemoryLayout<Int64>.size
+    static let secondsPerDay: Int64 = 24 * 3600
+
+    /// magic, version, then zeros up to `headerSize` (keeps the records 8-byte aligned in the mapping)
+    static var header: [UInt8] {
+        magic + [version] + [UInt8](repeating: 0, count: headerSize - magic.count - 1)
+    }
+
+    /// false for a new, truncated or foreign file, or another format version
+    static func isValidHeader(_ bytes: [UInt8]) -> Bool {
+        bytes.count >= headerSize && Array(bytes.prefix(magic.count + 1)) == magic + [version]
+    }
+
+    /// records in a file of `fileSize` bytes; a trailing partial record (crash mid-write) doesn't count
+    static func recordCount(fileSize: Int) -> Int {
+        max(0, (fileSize - headerSize) / recordSize)
+    }
+
+    /// the timestamp to append after `last`, so the column never goes backwards
+    static func appendable(_ timestamp: Int64, after last: Int64?) -> Int64 {
+        max(timestamp, last ?? .min)
+    }
+
+    static func day(_ timestamp: Int64) -> Int64 {
+        timestamp >= 0 ? timestamp / secondsPerDay : (timestamp + 1) / secondsPerDay - 1
+    }
+
+    /// offset of the first record ≥ `timestamp` in `column` (ascending), searching `range` (offsets) only
+    static func lowerBound<C: RandomAccessCollection>(_ column: C, _ timestamp: Int64, in range: Range<Int>? = nil) -> Int
+        where C.Element == Int64 {
+        var lo = range?.lowerBound ?? 0, hi = range?.upperBound ?? column.count
+        while lo < hi {
+            let m = (lo + hi) / 2
+            if column[column.index(column.startIndex, offsetBy: m)] < timestamp { lo = m + 1 } else { hi = m }
+        }
+        return lo
+    }
+
+    /// offset of the first record to keep, or nil when no record is older than `cutoff`
+    static func compactionStart<C: RandomAccessCollection>(_ column: C, cutoff: Int64) -> Int? where C.Element == Int64 {
+        let start = lowerBound(column, cutoff)
+        return start > 0 ? start : nil
+    }
+
+    /// Where each UTC day starts in a column, from its first record's day to its last one's. Appending is
+    /// O(1) amortized (plus one entry per empty day skipped); `count(since:)` is O(log of that day's records).
+    struct DayIndex {
+        private(set) var count = 0
+        private var firstDay: Int64 = 0
+        /// `dayStarts[d]`: offset of the first record on day `firstDay + d` or later
+        private var dayStarts = [Int]()
+
+        init() {}
+
+        init<C: Sequence>(_ column: C) where C.Element == Int64 {
+            for timestamp in column { append(timestamp) }
+        }
+
+        /// `timestamp` must not be before the last one appended (see `UsageLog.appendable`)
+        mutating func append(_ timestamp: Int64) {
+            let day = UsageLog.day(timestamp)
+            if dayStarts.isEmpty {
+                firstDay = day
+                dayStarts = [0]
+            }
+            while firstDay + Int64(dayStarts.count) <= day {
+                dayStarts.append(count)
+            }
+            count += 1
+        }
+
+        /// records at or after `since` in `column`, the column this index was built from
+        func count<C: RandomAccessCollection>(since: Int64, in column: C) -> Int where C.Element == Int64 {
+            guard count > 0 else { return 0 }
+            let offset = UsageLog.day(since) - firstDay
+            if offset < 0 { return count }
+            guard offset < Int64(dayStarts.count) else { return 0 }
+            let d = Int(offset)
+            let dayEnd = d + 1 < dayStarts.count ? dayStarts[d + 1] : count
+            return count - UsageLog.lowerBound(column, since, in: dayStarts[d]..<dayEnd)
+        }
+    }
+}
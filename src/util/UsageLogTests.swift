@@ -0,0 +1,128 @@
+import XCTest
+
+/// Pins the usage log format (header, whole records only, ascending columns), the day buckets that answer
+/// `count(since:)` without a scan, and where compaction cuts a column.
+final class UsageLogTests: XCTestCase {
+    private let day = UsageLog.secondsPerDay
+
+    /// a few events a day over `days` days, with some days skipped, starting at `start`
+    private func column(days: Int, start: Int64 = 1_700_000_000) -> [Int64] {
+        var seed: UInt64 = 7
+        var timestamps = [Int64]()
+        for d in 0..<Int64(days) where d % 5 != 3 {
+            seed = seed &* 6364136223846793005 &+ 1442695040888963407
+            for event in 0..<Int64(seed >> 61) {
+                timestamps.append(start + d * day + event * 3600)
+            }
+        }
+        return timestamps
+    }
+
+    // MARK: - A. Format
+
+    func testHeaderIsRecognized() {
+        XCTAssertTrue(UsageLog.isValidHeader(UsageLog.header))
+        XCTAssertEqual(UsageLog.header.count, UsageLog.headerSize)
+        XCTAssertFalse(UsageLog.isValidHeader([]), "new empty file")
+        XCTAssertFalse(UsageLog.isValidHeader(Array(UsageLog.header.prefix(8))), "truncated")
+        var otherVersion = UsageLog.header
+        otherVersion[4] += 1
+        XCTAssertFalse(UsageLog.isValidHeader(otherVersion))
+    }
+
+    func testPartialTrailingRecordIsIgnored() {
+        XCTAssertEqual(UsageLog.recordCount(fileSize: UsageLog.headerSize + 3 * UsageLog.recordSize + 5), 3)
+        XCTAssertEqual(UsageLog.recordCount(fileSize: UsageLog.headerSize), 0)
+        XCTAssertEqual(UsageLog.recordCount(fileSize: 0), 0)
+    }
+
+    func testTimestampsNeverGoBackwards() {
+        XCTAssertEqual(UsageLog.appendable(90, after: 100), 100, "clock went back: clamped")
+        XCTAssertEqual(UsageLog.appendable(110, after: 100), 110)
+        XCTAssertEqual(UsageLog.appendable(-5, after: nil), -5)
+    }
+
+    // MARK: - B. Day buckets
+
+    func testCountSinceMatchesALinearScan() {
+        let timestamps = column(days: 60)
+        let index = UsageLog.DayIndex(timestamps)
+        XCTAssertEqual(index.count, timestamps.count)
+        for since in stride(from: timestamps.first! - day, through: timestamps.last! + day, by: 1800) {
+            XCTAssertEqual(index.count(since: since, in: timestamps), timestamps.count { $0 >= since }, "since \(since)")
+        }
+    }
+
+    func testSinceBeforeTheFirstDayOrAfterTheLastOne() {
+        let timestamps = column(days: 10)
+        let index = UsageLog.DayIndex(timestamps)
+        XCTAssertEqual(index.count(since: Int64(Date.distantPast.timeIntervalSince1970), in: timestamps), timestamps.count)
+        XCTAssertEqual(index.count(since: timestamps.last! + 1, in: timestamps), 0)
+        XCTAssertEqual(index.count(since: Int64(Date.distantFuture.timeIntervalSince1970), in: timestamps), 0)
+    }
+
+    func testEmptyColumnCountsZero() {
+        XCTAssertEqual(UsageLog.DayIndex().count(since: 0, in: [Int64]()), 0)
+    }
+
+    func testNegativeTimestampsFallOnTheDayBefore() {
+        XCTAssertEqual(UsageLog.day(-1), -1)
+        XCTAssertEqual(UsageLog.day(-day), -1)
+        XCTAssertEqual(UsageLog.day(-day - 1), -2)
+        XCTAssertEqual(UsageLog.day(day - 1), 0)
+    }
+
+    func testAppendingKeepsTheIndexEqualToARebuild() {
+        let timestamps = column(days: 30)
+        var index = UsageLog.DayIndex()
+        for (i, timestamp) in timestamps.enumerated() {
+            index.append(timestamp)
+            let prefix = Array(timestamps[...i])
+            XCTAssertEqual(index.count(since: timestamp - day / 2, in: prefix), prefix.count { $0 >= timestamp - day / 2 })
+        }
+    }
+
+    // MARK: - C. Compaction
+
+    func testCompactionKeepsRecordsFromTheCutoffOn() {
+        XCTAssertEqual(UsageLog.compactionStart([10, 20, 20, 30], cutoff: 20), 1)
+        XCTAssertEqual(UsageLog.compactionStart([10, 20, 30], cutoff: 31), 3, "everything is old")
+        XCTAssertNil(UsageLog.compactionStart([10, 20, 30], cutoff: 10), "nothing to drop: the file isn't rewritten")
+        XCTAssertNil(UsageLog.compactionStart([Int64](), cutoff: 10))
+    }
+
+    // MARK: - D. Benchmarks
+
+    /// the About tab's week / month / year counts over a heavy user's year of triggers
+    func testBenchmarkCountSince() {
+        let timestamps = (0..<50_000).map { 1_700_000_000 + Int64($0) * 630 }
+        let index = UsageLog.DayIndex(timestamps)
+        let now = timestamps.last!
+        measure {
+            for _ in 0..<10_000 {
+                XCTAssertGreaterThan(index.count(since: now - 7 * day, in: timestamps), 0)
+            }
+        }
+    }
+
+    /// `UsageStats.usedProFeaturesSessionCount` over columns the way they're mapped: `Int64` buffers, no copies
+    func testBenchmarkProFeatureSessionCountOnMappedColumns() {
+        let triggers = (0..<50_000).map { 1_700_000_000 + Int64($0) * 630 }
+        let appIcons = triggers.enumerated().filter { $0.offset % 3 == 0 }.map { $0.element }
+        let searches = triggers.enumerated().filter { $0.offset % 7 == 0 }.map { $0.element + 5 }
+        let none = [Int64]()
+        triggers.withUnsafeBufferPointer { triggers in
+            appIcons.withUnsafeBufferPointer { appIcons in
+                searches.withUnsafeBufferPointer { searches in
+                    none.withUnsafeBufferPointer { none in
+                        measure {
+                            let sessions = UsageStatsTestable.proFeatureSessionCount(
+                                triggers: triggers, appIcons: appIcons, titles: none, extraShortcuts: none, searches: searches)
+                            XCTAssertGreaterThan(sessions, 0)
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -1,9 +1,33 @@
+import Foundation
+
+/// Usage counters behind the About tab and the Pro prompts. Each key is an append-only `UsageLog` column in
+/// Application Support, mapped read-only: recording an event appends one record, `count(_:since:)` reads the
+/// column's day buckets. Everything touching the columns runs on `queue`.
 struct UsageStats {
+    /// used to hold each key's timestamps as an `[Int]`; now only the migration flag
     private static let defaults = UserDefaults(suiteName: "\(App.bundleIdentifier).usage")!
-    private static let writeQueue = DispatchQueue(label: "UsageStats.writeQueue", qos: .utility)
+    private static let migratedKey = "migratedToUsageLog"
+    private static let queue = DispatchQueue(label: "UsageStats.queue", qos: .utility)
     private static let maxAge: TimeInterval = 365 * 24 * 3600
     private static let allKeys = ["triggers", "searches", "triggersAppIcons", "triggersTitles", "triggersAutoSize", "triggersExtraShortcuts"]
     private(set) static var searchRecordedThisSession = false
+    /// opened (and migrated) on first use, on `queue`
+    private static let columns: [String: UsageColumn] = {
+        let directory = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent(App.bundleIdentifier).appendingPathComponent("usage")
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        var columns = [String: UsageColumn]()
+        for key in allKeys {
+            let url = directory.appendingPathComponent("\(key).log")
+            if let column = UsageColumn(url) {
+                columns[key] = column
+            } else {
+                Logger.error { "Can't open the usage log \(url.path)" }
+            }
+        }
+        migrateFromUserDefaults(columns)
+        return columns
+    }()
 
     static func recordTrigger(_ shortcutIndex: Int) {
         record("triggers")
@@ -25,19 +49,24 @@ struct UsageStats {
     }
 
     static func count(_ key: String, since date: Date) -> Int {
-        let threshold = Int(date.timeIntervalSince1970)
-        return getTimestamps(key).count { $0 >= threshold }
+        let threshold = Int64(date.timeIntervalSince1970)
+        return queue.sync { columns[key]?.count(since: threshold) ?? 0 }
     }
 
     static var triggerCount: Int { count("triggers", since: Date.distantPast) }
 
     static var usedProFeaturesSessionCount: Int {
-        UsageStatsTestable.proFeatureSessionCount(
-            triggers: getTimestamps("triggers"),
-            appIcons: getTimestamps("triggersAppIcons"),
-            titles: getTimestamps("triggersTitles"),
-            extraShortcuts: getTimestamps("triggersExtraShortcuts"),
-            searches: getTimestamps("searches"))
+        queue.sync { () -> Int in
+            let column = { (key: String) -> UnsafeBufferPointer<Int64> in
+                columns[key]?.timestamps ?? UnsafeBufferPointer(start: nil, count: 0)
+            }
+            return UsageStatsTestable.proFeatureSessionCount(
+                triggers: column("triggers"),
+                appIcons: column("triggersAppIcons"),
+                titles: column("triggersTitles"),
+                extraShortcuts: column("triggersExtraShortcuts"),
+                searches: column("searches"))
+        }
     }
 
     static func formatCount(_ n: Int) -> String { UsageStatsTestable.formatCount(n) }
@@ -56,28 +85,159 @@ struct UsageStats {
     static func usedAutoSize() -> Bool { count("triggersAutoSize", since: Date.distantPast) > 0 }
     static func usedExtraShortcuts() -> Bool { count("triggersExtraShortcuts", since: Date.distantPast) > 0 }
 
-    static func prune() {
-        let cutoff = Int(Date().timeIntervalSince1970 - maxAge)
-        writeQueue.async {
-            for key in allKeys {
-                let timestamps = getTimestamps(key)
-                guard !timestamps.isEmpty else { continue }
-                let pruned = timestamps.filter { $0 >= cutoff }
-                defaults.set(pruned, forKey: key)
-            }
+    /// Drops the events older than `maxAge` by rewriting each column from its first recent record. Runs in the
+    /// background at launch; a column with nothing that old isn't touched.
+    static func compactInBackground() {
+        let cutoff = Int64(Date().timeIntervalSince1970 - maxAge)
+        queue.async {
+            for column in columns.values { column.compact(droppingBefore: cutoff) }
         }
     }
 
     private static func record(_ key: String) {
-        let now = Int(Date().timeIntervalSince1970)
-        writeQueue.async {
-            var timestamps = getTimestamps(key)
-            timestamps.append(now)
-            defaults.set(timestamps, forKey: key)
+        let now = Int64(Date().timeIntervalSince1970)
+        queue.async { _ = columns[key]?.append([now]) }
+    }
+
+    /// One-time move of the `[Int]` arrays this suite used to hold into the columns. A key is removed once its
+    /// column has it; the flag is set once all have moved, so a failed key is retried on the next launch.
+    private static func migrateFromUserDefaults(_ columns: [String: UsageColumn]) {
+        guard !defaults.bool(forKey: migratedKey) else { return }
+        var migratedAll = true
+        for key in allKeys {
+            guard let timestamps = defaults.array(forKey: key) as? [Int] else { continue }
+            if let column = columns[key], column.append(timestamps.sorted().map { Int64($0) }) {
+                defaults.removeObject(forKey: key)
+            } else {
+                migratedAll = false
+            }
         }
+        if migratedAll { defaults.set(true, forKey: migratedKey) }
+    }
+}
+
+/// One `UsageLog` column file: appended with `write(2)`, read through a read-only mapping. Not thread-safe;
+/// `UsageStats` only touches it on its queue.
+private final class UsageColumn {
+    private let url: URL
+    private var fd: Int32 = -1
+    private var mapping: UnsafeMutableRawPointer?
+    private var mappedBytes = 0
+    private var count = 0
+    private var last: Int64?
+    private var index = UsageLog.DayIndex()
+
+    init?(_ url: URL) {
+        self.url = url
+        guard openFile() else { return nil }
+    }
+
+    deinit {
+        closeFile()
+    }
+
+    /// the records, oldest first; valid until this column is read again, appended to past its mapping, or compacted
+    var timestamps: UnsafeBufferPointer<Int64> {
+        guard count > 0, mapIfNeeded(), let mapping else { return UnsafeBufferPointer(start: nil, count: 0) }
+        let records = mapping.advanced(by: UsageLog.headerSize).bindMemory(to: Int64.self, capacity: count)
+        return UnsafeBufferPointer(start: records, count: count)
+    }
+
+    func count(since timestamp: Int64) -> Int {
+        index.count(since: timestamp, in: timestamps)
+    }
+
+    /// appends the records in one write; on failure the file is cut back to what it held
+    func append(_ timestamps: [Int64]) -> Bool {
+        guard fd >= 0 else { return false }
+        var records = [Int64]()
+        records.reserveCapacity(timestamps.count)
+        for timestamp in timestamps {
+            records.append(UsageLog.appendable(timestamp, after: records.last ?? last))
+        }
+        let bytes = records.count * UsageLog.recordSize
+        let written = records.withUnsafeBytes { Darwin.write(fd, $0.baseAddress, $0.count) }
+        guard written == bytes else {
+            Logger.error { "Can't append to the usage log \(url.path)" }
+            ftruncate(fd, off_t(UsageLog.headerSize + count * UsageLog.recordSize))
+            return false
+        }
+        for record in records { index.append(record) }
+        count += records.count
+        last = records.last ?? last
+        return true
+    }
+
+    func compact(droppingBefore cutoff: Int64) {
+        let column = timestamps
+        guard let start = UsageLog.compactionStart(column, cutoff: cutoff) else { return }
+        var data = Data(UsageLog.header)
+        data.append(UnsafeBufferPointer(rebasing: column[start...]))
+        do {
+            try data.write(to: url, options: .atomic)
+        } catch {
+            Logger.error { "Can't compact the usage log \(url.path): \(error)" }
+            return
+        }
+        closeFile()
+        if !openFile() { Logger.error { "Can't reopen the usage log \(url.path)" } }
+    }
+
+    /// opens (or creates) the file, drops a partial trailing record, and indexes the records
+    private func openFile() -> Bool {
+        fd = Darwin.open(url.path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0o644)
+        guard fd >= 0 else { return false }
+        var info = stat()
+        var header = [UInt8](repeating: 0, count: UsageLog.headerSize)
+        guard fstat(fd, &info) == 0 else { closeFile(); return false }
+        var size = Int(info.st_size)
+        if pread(fd, &header, header.count, 0) != header.count || !UsageLog.isValidHeader(header) {
+            // new file, or not one we can read: start an empty column
+            guard ftruncate(fd, 0) == 0, UsageLog.header.withUnsafeBytes({ Darwin.write(fd, $0.baseAddress, $0.count) }) == UsageLog.headerSize else {
+                closeFile()
+                return false
+            }
+            size = UsageLog.headerSize
+        }
+        count = UsageLog.recordCount(fileSize: size)
+        let wholeRecords = UsageLog.headerSize + count * UsageLog.recordSize
+        if wholeRecords < size { ftruncate(fd, off_t(wholeRecords)) }
+        guard count == 0 || mapIfNeeded() else { closeFile(); return false }
+        let column = timestamps
+        index = UsageLog.DayIndex(column)
+        last = column.last
+        return true
+    }
+
+    /// Maps at least twice the current records (whole pages), so appends don't remap on every read. Pages
+    /// past the end of the file are never touched: reads stop at `count`.
+    private func mapIfNeeded() -> Bool {
+        let needed = UsageLog.headerSize + count * UsageLog.recordSize
+        if mapping != nil && needed <= mappedBytes { return true }
+        unmap()
+        let page = Int(getpagesize())
+        let length = (max(needed * 2, 16 * page) + page - 1) / page * page
+        guard let mapped = mmap(nil, length, PROT_READ, MAP_SHARED, fd, 0), mapped != UnsafeMutableRawPointer(bitPattern: -1) else {
+            Logger.error { "Can't map the usage log \(url.path)" }
+            return false
+        }
+        mapping = mapped
+        mappedBytes = length
+        return true
+    }
+
+    private func unmap() {
+        if let mapping { munmap(mapping, mappedBytes) }
+        mapping = nil
+        mappedBytes = 0
     }
 
-    private static func getTimestamps(_ key: String) -> [Int] {
-        defaults.array(forKey: key) as? [Int] ?? []
+    private func closeFile() {
+        unmap()
+        if fd >= 0 { Darwin.close(fd) }
+        fd = -1
+        count = 0
+        last = nil
+        index = UsageLog.DayIndex()
     }
 }
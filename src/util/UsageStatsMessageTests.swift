@@ -47,6 +47,27 @@ final class UsageStatsTestableMessageTests: XCTestCase {
         XCTAssertEqual(result, 2)
     }
 
+    func testUnsortedTriggers_sameCount() {
+        XCTAssertEqual(count(triggers: [200, 100], appIcons: [100], searches: [250]), 2)
+    }
+
+    func testMappedInt64Columns_sameCountAsArrays() {
+        let triggers: [Int64] = [100, 100, 200, 300]
+        let appIcons: [Int64] = [100, 100]
+        let searches: [Int64] = [205, 50]
+        let result = triggers.withUnsafeBufferPointer { triggers in
+            appIcons.withUnsafeBufferPointer { appIcons in
+                searches.withUnsafeBufferPointer { searches in
+                    UsageStatsTestable.proFeatureSessionCount(triggers: triggers, appIcons: appIcons,
+                        titles: UnsafeBufferPointer(start: nil, count: 0), extraShortcuts: UnsafeBufferPointer(start: nil, count: 0),
+                        searches: searches)
+                }
+            }
+        }
+        XCTAssertEqual(result, count(triggers: [100, 100, 200, 300], appIcons: [100, 100], searches: [205, 50]))
+        XCTAssertEqual(result, 2)
+    }
+
     func testFormatCount_thousandSeparator() {
         XCTAssertEqual(UsageStatsTestable.formatCount(1), "1")
         XCTAssertEqual(UsageStatsTestable.formatCount(999), "999")
@@ -12,31 +12,42 @@ class UsageStatsTestable {
 
     /// Trigger-time features share the trigger timestamp by construction (same `recordTrigger` call).
     /// Searches happen later in the session, so map each back to the latest trigger ≤ search ts.
-    /// Final intersect clamps the result to actual triggers — guarantees column 2 ≤ column 1.
-    static func proFeatureSessionCount(triggers: [Int], appIcons: [Int], titles: [Int],
-                                       extraShortcuts: [Int], searches: [Int]) -> Int {
+    /// Feature timestamps only count when they match a trigger — guarantees column 2 ≤ column 1.
+    /// Generic so `UsageStats` can pass its mapped `UsageLog` columns as is: no copies, only binary searches
+    /// into `triggers` (sorted first if they aren't already, as the mapped columns always are).
+    static func proFeatureSessionCount<Triggers: RandomAccessCollection, Features: Collection>(
+        triggers: Triggers, appIcons: Features, titles: Features, extraShortcuts: Features, searches: Features) -> Int
+        where Triggers.Element: BinaryInteger, Features.Element: BinaryInteger {
         guard !triggers.isEmpty else { return 0 }
-        var sessions = Set<Int>()
-        sessions.formUnion(appIcons)
-        sessions.formUnion(titles)
-        sessions.formUnion(extraShortcuts)
-        let sortedTriggers = triggers.sorted()
+        guard zip(triggers, triggers.dropFirst()).allSatisfy({ $0 <= $1 }) else {
+            return proFeatureSessionCount(triggers: triggers.sorted(), appIcons: appIcons, titles: titles,
+                extraShortcuts: extraShortcuts, searches: searches)
+        }
+        var sessions = Set<Int64>()
+        for column in [appIcons, titles, extraShortcuts] {
+            for feature in column {
+                let timestamp = Int64(feature)
+                if mostRecentTrigger(in: triggers, atOrBefore: timestamp) == timestamp {
+                    sessions.insert(timestamp)
+                }
+            }
+        }
         for s in searches {
-            if let owning = mostRecentTrigger(in: sortedTriggers, atOrBefore: s) {
+            if let owning = mostRecentTrigger(in: triggers, atOrBefore: Int64(s)) {
                 sessions.insert(owning)
             }
         }
-        sessions.formIntersection(triggers)
         return sessions.count
     }
 
-    private static func mostRecentTrigger(in sorted: [Int], atOrBefore target: Int) -> Int? {
+    private static func mostRecentTrigger<C: RandomAccessCollection>(in sorted: C, atOrBefore target: Int64) -> Int64?
+        where C.Element: BinaryInteger {
         var lo = 0, hi = sorted.count
         while lo < hi {
             let m = (lo + hi) / 2
-            if sorted[m] <= target { lo = m + 1 } else { hi = m }
+            if Int64(sorted[sorted.index(sorted.startIndex, offsetBy: m)]) <= target { lo = m + 1 } else { hi = m }
         }
-        return lo > 0 ? sorted[lo - 1] : nil
+        return lo > 0 ? Int64(sorted[sorted.index(sorted.startIndex, offsetBy: lo - 1)]) : nil
     }
 
     static func formatCount(_ count: Int) -> String {
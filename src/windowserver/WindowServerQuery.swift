@@ -24,6 +24,7 @@ enum WindowServerQuery {
                 bounds: SLSWindowIteratorGetBounds(iterator)
             ))
         }
+        WsTraceRecorder.snapshot(out)
         return out
     }
 }
@@ -0,0 +1,504 @@
+import Cocoa
+
+/// One line of a recorded WindowServer-pipeline trace (JSONL: one JSON object per line, see `WsTrace`).
+/// `t` is monotonic nanoseconds since recording started. Flat on purpose, so a line stays greppable and a
+/// storm can be hand-written in a test.
+struct WsTraceEvent: Codable, Equatable {
+    enum Kind: String, Codable {
+        case notification  // a raw notify-proc callback
+        case snapshot      // a `WindowServerQuery` batch result
+        case axCompletion  // one AX call attempt finished (or timed out) on an `AXCallScheduler` lane
+    }
+
+    let t: UInt64
+    let kind: Kind
+    var code: UInt32? = nil            // notification id
+    var wid: CGWindowID? = nil         // notification payload w0
+    var space: UInt64? = nil           // 1325/1326 payload
+    var widInSpace: CGWindowID? = nil  // 1325/1326 payload
+    var windows: [WsRawWindow]? = nil  // snapshot
+    var key: String? = nil             // axCompletion: the `AXCallScheduler` key
+    var pid: pid_t? = nil              // axCompletion
+    var durationNs: UInt64? = nil      // axCompletion: how long the attempt held its worker
+    var timedOut: Bool? = nil          // axCompletion: the attempt failed (app unresponsive) and will be retried
+
+    static func notification(_ t: UInt64, _ n: WsEventRouting.Notification, wid: CGWindowID, space: UInt64? = nil, widInSpace: CGWindowID? = nil) -> WsTraceEvent {
+        WsTraceEvent(t: t, kind: .notification, code: n.rawValue, wid: wid, space: space, widInSpace: widInSpace)
+    }
+
+    static func snapshot(_ t: UInt64, _ windows: [WsRawWindow]) -> WsTraceEvent {
+        WsTraceEvent(t: t, kind: .snapshot, windows: windows)
+    }
+
+    static func axCompletion(_ t: UInt64, key: String, pid: pid_t?, durationNs: UInt64, timedOut: Bool) -> WsTraceEvent {
+        WsTraceEvent(t: t, kind: .axCompletion, key: key, pid: pid, durationNs: durationNs, timedOut: timedOut)
+    }
+}
+
+enum WsTrace {
+    static func encodeLine(_ event: WsTraceEvent) throws -> Data {
+        var line = try JSONEncoder().encode(event)
+        line.append(0x0A)
+        return line
+    }
+
+    static func decode(_ jsonl: Data) throws -> [WsTraceEvent] {
+        let decoder = JSONDecoder()
+        return try jsonl.split(separator: 0x0A).map { try decoder.decode(WsTraceEvent.self, from: Data($0)) }
+    }
+}
+
+/// Deterministic replay of a trace through the pipeline's pure decisions against a virtual clock: routing
+/// (`WsEventRouting`), the Space-transition mute + debounce of `WindowServerEvents`, per-key throttling
+/// (`ThrottleDecision`), and `AXCallScheduler`'s lanes, per-key in-flight dedup and retry/quarantine
+/// (`AxQueryRouting`, and the scheduler's own `AxCallKeyState`). No AppKit, queues or real clocks. AX
+/// attempt outcomes come from the trace's `axCompletion` records, consumed per key in order; calls with no
+/// record succeed after `defaultAxDurationNs`. See `WsEventReplaySpecs.md` for what each notification turns into.
+struct WsEventReplay {
+    enum Lane: String, CaseIterable {
+        case firstTry, scan, retry, cgsCall
+    }
+
+    struct Config {
+        var laneWidths: [Lane: Int] = [.firstTry: 8, .scan: 6, .retry: 6, .cgsCall: 4]
+        var attributesThrottleNs: UInt64 = 200_000_000     // Applications.windowAttributesThrottler
+        var spaceTransitionNs: UInt64 = 500_000_000        // WindowServerEvents.inSpaceTransition
+        var spaceChangeDebounceNs: UInt64 = 250_000_000    // WindowServerEvents.scheduleSpaceChangeHandling
+        var defaultAxDurationNs: UInt64 = 2_000_000
+        var cgsDurationNs: UInt64 = 100_000
+    }
+
+    struct LaneStats: Equatable {
+        var submitted = 0
+        var peakDepth = 0      // ops waiting for a worker (running ones excluded)
+        var depthSum = 0       // depth seen by each submission, for `meanDepth`
+        var meanDepth: Double { submitted == 0 ? 0 : Double(depthSum) / Double(submitted) }
+    }
+
+    struct Report: Equatable {
+        var notifications = 0
+        /// per notification: virtual ns from arrival until all the work it triggered finished (0 if none)
+        var latenciesNs = [UInt64]()
+        var coalescible = 0
+        var coalesced = 0
+        var lanes = [Lane: LaneStats]()
+        var axAttempts = 0
+        var retries = 0
+        var cancelledRetries = 0
+        var giveUps = 0
+        var quarantinedPids = Set<pid_t>()
+        var endNs: UInt64 = 0
+
+        /// share of coalescible calls (throttle / debounce / AX in-flight dedup) that didn't run on their own
+        var coalescingRatio: Double { coalescible == 0 ? 0 : Double(coalesced) / Double(coalescible) }
+
+        func latencyPercentileNs(_ p: Double) -> UInt64 {
+            guard !latenciesNs.isEmpty else { return 0 }
+            let sorted = latenciesNs.sorted()
+            let rank = Int((p / 100 * Double(sorted.count)).rounded(.up)) - 1
+            return sorted[min(max(0, rank), sorted.count - 1)]
+        }
+    }
+
+    static func run(_ trace: [WsTraceEvent], config: Config = Config()) -> Report {
+        var replay = WsEventReplay(config)
+        // stable: a snapshot and the notification it explains often share a timestamp
+        let ordered = trace.enumerated().sorted { ($0.element.t, $0.offset) < ($1.element.t, $1.offset) }.map { $0.element }
+        replay.replay(ordered)
+        return replay.report
+    }
+
+    // MARK: - Simulation
+
+    private enum Work {
+        case discoverQuery(CGWindowID)    // Applications.discoverWindow's CGS query
+        case stateQuery                   // Applications.updateWindowStatesViaWindowServer
+        case spaceSync                    // Applications.syncSpacesState
+        case ax(String, attempt: Int)     // an AXCallScheduler attempt for a key
+    }
+
+    private enum Deadline {
+        case throttleTail(String)
+        case spaceSettled
+        case workDone(Lane, Work, origins: [Int])
+        case retryDue(String, attempt: Int)
+    }
+
+    private struct AxCall {
+        var pid: pid_t?
+        var scan: Bool
+        var origins: [Int]
+        var onSuccess: CGWindowID?        // an acquire: the wid becomes tracked
+    }
+
+    private struct AxKey {
+        var state = AxCallKeyState<AxCall>()  // the scheduler's own per-key machine
+        var current = AxCall(pid: nil, scan: false, origins: [])
+        var retryStartNs: UInt64 = 0
+        var attempt = 0
+        var skipped = false               // the current attempt saw `cancelRetries` when it started, so never ran
+    }
+
+    private struct ThrottleKey {
+        let wid: CGWindowID
+        let discover: Bool  // the `wid-N-discover` key (else `wid-N-wsstate`)
+        var lastFireNs: UInt64?
+        var tailScheduled = false
+        var tailOrigins = [Int]()
+    }
+
+    private let config: Config
+    private var report = Report()
+    private var now: UInt64 = 0
+    private var timers = [(at: UInt64, seq: Int, timer: Deadline)]()  // binary min-heap on (at, seq): FIFO among equals
+    private var timerSeq = 0
+    private var arrivals = [UInt64]()
+    private var outstanding = [Int]()       // per notification: unfinished work items it's waiting on
+    private var known = [CGWindowID: WsRawWindow]()
+    private var tracked = Set<CGWindowID>()
+    private var seeded = false
+    private var spaceTransitionUntil: UInt64 = 0
+    private var spaceOrigins = [Int]()
+    private var spaceSettleAt: UInt64?
+    private var throttles = [String: ThrottleKey]()
+    private var axKeys = [String: AxKey]()
+    private var unresponsive = Set<pid_t>()
+    private var outcomes = [String: [(durationNs: UInt64, timedOut: Bool)]]()
+    private var running = [Lane: Int]()
+    private var waiting = [Lane: AxFairQueue<(work: Work, origins: [Int])>]()
+    private var costs = AxCallCost()
+
+    private init(_ config: Config) {
+        self.config = config
+    }
+
+    private mutating func replay(_ trace: [WsTraceEvent]) {
+        for event in trace where event.kind == .axCompletion {
+            guard let key = event.key else { continue }
+            outcomes[key, default: []].append((event.durationNs ?? config.defaultAxDurationNs, event.timedOut ?? false))
+        }
+        for event in trace {
+            fireTimers(upTo: event.t)
+            now = max(now, event.t)
+            switch event.kind {
+                case .snapshot: applySnapshot(event.windows ?? [])
+                case .notification: handle(event)
+                case .axCompletion: break
+            }
+        }
+        fireTimers(upTo: .max)
+        report.endNs = now
+    }
+
+    private mutating func applySnapshot(_ windows: [WsRawWindow]) {
+        for raw in windows { known[raw.wid] = raw }
+        // the first snapshot is the model at recording start; later ones only refresh what discovery can see
+        if !seeded {
+            seeded = true
+            tracked = Set(windows.filter { WsWindowState.isApplicationWindowLevel($0) }.map { $0.wid })
+        }
+    }
+
+    // MARK: Routing (mirrors WindowServerEvents.handle + route)
+
+    private mutating func handle(_ event: WsTraceEvent) {
+        guard let code = event.code, let n = WsEventRouting.notification(code) else { return }
+        let origin = arrivals.count
+        arrivals.append(now)
+        outstanding.append(0)
+        report.notifications += 1
+        report.latenciesNs.append(0)
+        let w0 = event.wid ?? 0
+        let inSpaceTransition = now < spaceTransitionUntil
+        if n == .activeSpaceChanged || n == .spaceCurrentChanged { spaceTransitionUntil = now + config.spaceTransitionNs }
+        switch WsEventRouting.action(for: n) {
+            case .bumpFocusOrder:
+                if !tracked.contains(w0) { startWork(.discoverQuery(w0), on: .cgsCall, origins: [origin]) }
+            case .remove:
+                tracked.remove(w0)
+                known[w0] = nil
+            case .updateGeometry, .refreshVisibility:
+                if tracked.contains(w0), let pid = known[w0]?.pid {
+                    if n == .windowOrderedOut && !inSpaceTransition {
+                        schedule(axKey: "wid-\(w0)-liveness", pid: pid, scan: false, origins: [origin])
+                        schedule(axKey: "wid-\(w0)-generic", pid: pid, scan: true, origins: [origin])
+                    } else {
+                        throttle("wid-\(w0)-wsstate", wid: w0, discover: false, origin: origin)
+                        if n == .windowOrderedIn { schedule(axKey: "wid-\(w0)-generic", pid: pid, scan: true, origins: [origin]) }
+                    }
+                } else if !tracked.contains(w0) && !inSpaceTransition && (n == .windowMoved || n == .windowResized || n == .windowOrderedIn) {
+                    throttle("wid-\(w0)-discover", wid: w0, discover: true, origin: origin)
+                }
+            case .updateSpaceMembership:
+                break
+            case .acquireAndDiscriminate:
+                if !inSpaceTransition { startWork(.discoverQuery(w0), on: .cgsCall, origins: [origin]) }
+            case .spaceTransition:
+                report.coalescible += 1
+                if spaceSettleAt != nil { report.coalesced += 1 }
+                spaceOrigins.append(origin)
+                outstanding[origin] += 1
+                spaceSettleAt = now + config.spaceChangeDebounceNs
+                addTimer(at: spaceSettleAt!, .spaceSettled)
+        }
+    }
+
+    // MARK: Throttling (mirrors ThrottlerWithKey)
+
+    private mutating func throttle(_ key: String, wid: CGWindowID, discover: Bool, origin: Int) {
+        report.coalescible += 1
+        var state = throttles[key] ?? ThrottleKey(wid: wid, discover: discover)
+        switch ThrottleDecision.decide(lastFireNs: state.lastFireNs, nowNs: now, delayNs: config.attributesThrottleNs, tailScheduled: state.tailScheduled) {
+            case .runNow:
+                state.lastFireNs = now
+                throttles[key] = state
+                runThrottled(wid: wid, discover: discover, origins: [origin])
+            case .coalesce:
+                report.coalesced += 1
+                state.tailOrigins.append(origin)
+                outstanding[origin] += 1
+                throttles[key] = state
+            case .scheduleTail(let remainingNs):
+                state.tailScheduled = true
+                state.tailOrigins.append(origin)
+                outstanding[origin] += 1
+                throttles[key] = state
+                addTimer(at: now + remainingNs, .throttleTail(key))
+        }
+    }
+
+    private mutating func runThrottled(wid: CGWindowID, discover: Bool, origins: [Int]) {
+        startWork(discover ? .discoverQuery(wid) : .stateQuery, on: .cgsCall, origins: origins)
+    }
+
+    // MARK: AX scheduling (drives AXCallScheduler's `AxCallKeyState`, mirroring schedule / attemptBlock / drainPending)
+
+    private mutating func schedule(axKey key: String, pid: pid_t?, scan: Bool, origins: [Int], onSuccess: CGWindowID? = nil) {
+        var ax = axKeys[key] ?? AxKey()
+        for origin in origins { outstanding[origin] += 1 }
+        // whoever waited on a replaced held call now waits on the newer one
+        let held = ax.state.heldCall
+        let call = AxCall(pid: pid, scan: scan, origins: (held?.origins ?? []) + origins, onSuccess: onSuccess ?? held?.onSuccess)
+        switch ax.state.schedule(call) {
+            case .submit:
+                ax.current = call
+                axKeys[key] = ax
+                submitAttempt(key)
+            case .held(let replaced):
+                report.coalescible += 1
+                if replaced != nil { report.coalesced += 1 }
+                axKeys[key] = ax
+        }
+    }
+
+    private mutating func submitAttempt(_ key: String) {
+        let call = axKeys[key]!.current
+        let pool = AxQueryRouting.pool(unresponsive: call.pid.map { unresponsive.contains($0) } ?? false, scan: call.scan)
+        let lane: Lane = pool == .firstTry ? .firstTry : (pool == .scan ? .scan : .retry)
+        axKeys[key]!.attempt += 1
+        axKeys[key]!.retryStartNs = 0
+        enqueue(.ax(key, attempt: axKeys[key]!.attempt), on: lane, origins: [])
+    }
+
+    /// An attempt got a worker: returns how long it holds it
+    private mutating func startAttempt(_ key: String) -> UInt64 {
+        guard var ax = axKeys[key] else { return 0 }
+        ax.skipped = ax.state.cancelRetries
+        if ax.skipped {
+            axKeys[key] = ax
+            return 0
+        }
+        if ax.state.phase != .retrying { ax.retryStartNs = now }
+        axKeys[key] = ax
+        report.axAttempts += 1
+        return outcomes[key]?.first?.durationNs ?? config.defaultAxDurationNs
+    }
+
+    private mutating func finishAttempt(_ key: String) {
+        guard var ax = axKeys[key] else { return }
+        if ax.skipped {
+            report.cancelledRetries += 1
+            drainPending(key, superseded: ax.current.origins)
+            return
+        }
+        let pid = ax.current.pid
+        costs.record(pid: pid, durationNs: outcomes[key]?.first?.durationNs ?? config.defaultAxDurationNs)
+        let timedOut = outcomes[key].map { !$0.isEmpty && $0[0].timedOut } ?? false
+        if outcomes[key]?.isEmpty == false { outcomes[key]!.removeFirst() }
+        if let pid {
+            if timedOut {
+                unresponsive.insert(pid)
+                report.quarantinedPids.insert(pid)
+            } else {
+                unresponsive.remove(pid)
+            }
+        }
+        let outcome = ax.state.attemptEnded(succeeded: !timedOut, elapsedSinceStartNs: now - ax.retryStartNs)
+        switch outcome {
+            case .succeeded:
+                if let wid = ax.current.onSuccess, known[wid] != nil { tracked.insert(wid) }
+            case .gaveUp:
+                report.giveUps += 1
+                if let pid { unresponsive.remove(pid) }
+            case .retry(let delayNs):
+                ax.attempt += 1
+                report.retries += 1
+                addTimer(at: now + delayNs, .retryDue(key, attempt: ax.attempt))
+        }
+        axKeys[key] = ax
+        if outcome == .succeeded || outcome == .gaveUp { complete(key) }
+    }
+
+    private mutating func complete(_ key: String) {
+        guard let ax = axKeys[key] else { return }
+        let origins = ax.current.origins
+        drainPending(key, superseded: [])
+        finish(origins)
+    }
+
+    private mutating func drainPending(_ key: String, superseded: [Int]) {
+        guard var ax = axKeys[key] else { return }
+        ax.skipped = false
+        guard var call = ax.state.next() else {
+            axKeys[key] = ax
+            finish(superseded)
+            return
+        }
+        call.origins += superseded  // whoever waited on a cancelled attempt now waits on this one
+        ax.current = call
+        axKeys[key] = ax
+        submitAttempt(key)
+    }
+
+    // MARK: Lanes (mirrors LabeledOperationQueue's bounded width + AXCallScheduler's AxFairQueue per lane)
+
+    private mutating func startWork(_ work: Work, on lane: Lane, origins: [Int]) {
+        for origin in origins { outstanding[origin] += 1 }
+        enqueue(work, on: lane, origins: origins)
+    }
+
+    private mutating func enqueue(_ work: Work, on lane: Lane, origins: [Int]) {
+        var stats = report.lanes[lane] ?? LaneStats()
+        let depth = waiting[lane]?.count ?? 0
+        stats.submitted += 1
+        stats.depthSum += depth
+        if (running[lane] ?? 0) >= (config.laneWidths[lane] ?? 1) {
+            if case .ax(let key, _) = work {
+                let pid = axKeys[key]?.current.pid
+                waiting[lane, default: AxFairQueue()].enqueue((work, origins), key: key, pid: pid, costMs: costs.costMs(pid: pid))
+            } else {
+                // CGS work has no app: one flow, so plain FIFO
+                waiting[lane, default: AxFairQueue()].enqueue((work, origins), key: "cgs", pid: nil)
+            }
+            stats.peakDepth = max(stats.peakDepth, depth + 1)
+        } else {
+            begin(work, on: lane, origins: origins)
+        }
+        report.lanes[lane] = stats
+    }
+
+    private mutating func begin(_ work: Work, on lane: Lane, origins: [Int]) {
+        running[lane, default: 0] += 1
+        let durationNs: UInt64
+        switch work {
+            case .ax(let key, _): durationNs = startAttempt(key)
+            default: durationNs = config.cgsDurationNs
+        }
+        addTimer(at: now + durationNs, .workDone(lane, work, origins: origins))
+    }
+
+    private mutating func workDone(_ lane: Lane, _ work: Work, origins: [Int]) {
+        running[lane, default: 1] -= 1
+        if let next = waiting[lane]?.dequeue() {
+            begin(next.job.work, on: lane, origins: next.job.origins)
+        }
+        switch work {
+            case .discoverQuery(let wid):
+                // discoverWindow: an application-level window gets its AX element acquired on the scan lane
+                if let raw = known[wid], WsWindowState.isApplicationWindowLevel(raw), !tracked.contains(wid) {
+                    schedule(axKey: "wid-\(wid)-acquire", pid: raw.pid, scan: true, origins: origins, onSuccess: wid)
+                }
+            case .stateQuery, .spaceSync:
+                break
+            case .ax(let key, _):
+                finishAttempt(key)
+        }
+        finish(origins)
+    }
+
+    // MARK: Clock
+
+    private static func firesBefore(_ a: (at: UInt64, seq: Int, timer: Deadline), _ b: (at: UInt64, seq: Int, timer: Deadline)) -> Bool {
+        (a.at, a.seq) < (b.at, b.seq)
+    }
+
+    private mutating func addTimer(at: UInt64, _ timer: Deadline) {
+        timers.append((at: at, seq: timerSeq, timer: timer))
+        timerSeq += 1
+        var c = timers.count - 1
+        while c > 0 {
+            let p = (c - 1) / 2
+            if !Self.firesBefore(timers[c], timers[p]) { return }
+            timers.swapAt(p, c)
+            c = p
+        }
+    }
+
+    private mutating func popTimer() -> (at: UInt64, seq: Int, timer: Deadline) {
+        let first = timers[0]
+        let last = timers.removeLast()
+        guard !timers.isEmpty else { return first }
+        timers[0] = last
+        var p = 0
+        while true {
+            var earliest = p
+            let left = 2 * p + 1
+            let right = left + 1
+            if left < timers.count && Self.firesBefore(timers[left], timers[earliest]) { earliest = left }
+            if right < timers.count && Self.firesBefore(timers[right], timers[earliest]) { earliest = right }
+            if earliest == p { return first }
+            timers.swapAt(p, earliest)
+            p = earliest
+        }
+    }
+
+    private mutating func fireTimers(upTo limit: UInt64) {
+        while let head = timers.first, head.at <= limit {
+            let next = popTimer()
+            now = max(now, next.at)
+            switch next.timer {
+                case .throttleTail(let key):
+                    guard var state = throttles[key], state.tailScheduled else { continue }
+                    let origins = state.tailOrigins
+                    state.tailScheduled = false
+                    state.tailOrigins = []
+                    state.lastFireNs = now
+                    throttles[key] = state
+                    runThrottled(wid: state.wid, discover: state.discover, origins: origins)
+                    finish(origins)
+                case .spaceSettled:
+                    // a later 1329/1401 pushed the debounce out: this timer was cancelled
+                    guard spaceSettleAt == next.at else { continue }
+                    spaceSettleAt = nil
+                    let origins = spaceOrigins
+                    spaceOrigins = []
+                    startWork(.spaceSync, on: .cgsCall, origins: origins)
+                    if !tracked.isEmpty { startWork(.stateQuery, on: .cgsCall, origins: origins) }
+                    finish(origins)
+                case .workDone(let lane, let work, let origins):
+                    workDone(lane, work, origins: origins)
+                case .retryDue(let key, let attempt):
+                    guard let ax = axKeys[key], ax.attempt == attempt else { continue }
+                    enqueue(.ax(key, attempt: attempt), on: .retry, origins: [])
+            }
+        }
+    }
+
+    /// One unit of work each of `origins` waited on is done; a notification's latency is set when its last one is
+    private mutating func finish(_ origins: [Int]) {
+        for origin in origins {
+            outstanding[origin] -= 1
+            if outstanding[origin] == 0 { report.latenciesNs[origin] = now - arrivals[origin] }
+        }
+    }
+}
@@ -0,0 +1,160 @@
+import XCTest
+
+/// Replays synthetic WindowServer traces through `WsEventReplay` and pins what the pipeline does with
+/// them: how much it coalesces, how deep each lane gets, how long each notification waits, and how AX
+/// timeouts turn into retries, quarantine and give-ups. Storms that regress show up here, not on a Mac.
+final class WsEventReplayTests: XCTestCase {
+    private let ms: UInt64 = 1_000_000
+
+    private func raw(_ wid: CGWindowID, pid: pid_t = 42, level: Int32 = 0) -> WsRawWindow {
+        WsRawWindow(wid: wid, pid: pid, attributes: 0x2, level: level, spaceTypeMask: 0, title: "w\(wid)")
+    }
+
+    // MARK: - A. Trace format
+
+    func testJsonlRoundTrip() throws {
+        var window = raw(7)
+        window.bounds = CGRect(x: 10, y: 20, width: 300, height: 200)
+        let trace: [WsTraceEvent] = [
+            .snapshot(0, [window]),
+            .notification(5, .windowAddedToSpace, wid: 0, space: 3, widInSpace: 7),
+            .axCompletion(9, key: "wid-7-generic", pid: 42, durationNs: 4, timedOut: true),
+        ]
+        var jsonl = Data()
+        for event in trace { jsonl.append(try WsTrace.encodeLine(event)) }
+        XCTAssertEqual(try WsTrace.decode(jsonl), trace)
+        XCTAssertEqual(jsonl.filter { $0 == 0x0A }.count, trace.count, "one event per line")
+    }
+
+    // MARK: - B. Routing
+
+    func testTrackedResizesCoalesceOnTheWsStateThrottle() {
+        let report = WsEventReplay.run([
+            .snapshot(0, [raw(1)]),
+            .notification(1 * ms, .windowResized, wid: 1),
+            .notification(50 * ms, .windowResized, wid: 1),
+            .notification(100 * ms, .windowResized, wid: 1),
+        ])
+        XCTAssertEqual(report.coalescible, 3)
+        XCTAssertEqual(report.coalesced, 1, "the third resize rides the tail the second one scheduled")
+        XCTAssertEqual(report.lanes[.cgsCall]?.submitted, 2, "leading edge + one trailing run")
+        XCTAssertEqual(report.latenciesNs[1], 201 * ms - 50 * ms + WsEventReplay.Config().cgsDurationNs)
+    }
+
+    func testCreatedWindowIsDiscoveredThenAcquiredOnTheScanLane() {
+        let report = WsEventReplay.run([
+            .snapshot(0, []),
+            .snapshot(1 * ms, [raw(7)]),
+            .notification(2 * ms, .windowCreated, wid: 7),
+            .notification(500 * ms, .windowResized, wid: 7),
+        ])
+        XCTAssertEqual(report.lanes[.scan]?.submitted, 1)
+        XCTAssertEqual(report.lanes[.cgsCall]?.submitted, 2, "the discovery query, then the tracked window's state query")
+        let config = WsEventReplay.Config()
+        XCTAssertEqual(report.latenciesNs[0], config.cgsDurationNs + config.defaultAxDurationNs)
+    }
+
+    func testNonApplicationLevelWindowIsNotAcquired() {
+        let report = WsEventReplay.run([
+            .snapshot(0, []),
+            .snapshot(1 * ms, [raw(7, level: 25)]),
+            .notification(2 * ms, .windowCreated, wid: 7),
+        ])
+        XCTAssertEqual(report.lanes[.cgsCall]?.submitted, 1)
+        XCTAssertNil(report.lanes[.scan])
+    }
+
+    func testCreatedDuringSpaceTransitionIsIgnored() {
+        let report = WsEventReplay.run([
+            .snapshot(0, []),
+            .snapshot(1 * ms, [raw(7)]),
+            .notification(2 * ms, .activeSpaceChanged, wid: 0),
+            .notification(3 * ms, .windowCreated, wid: 7),
+        ])
+        XCTAssertEqual(report.latenciesNs[1], 0, "no work was triggered")
+        XCTAssertNil(report.lanes[.scan])
+    }
+
+    func testSpaceChangesDebounceIntoOneSync() {
+        let report = WsEventReplay.run([
+            .snapshot(0, [raw(1)]),
+            .notification(0, .spaceCurrentChanged, wid: 0),
+            .notification(100 * ms, .activeSpaceChanged, wid: 0),
+        ])
+        XCTAssertEqual(report.coalesced, 1)
+        XCTAssertEqual(report.lanes[.cgsCall]?.submitted, 2, "one Space sync + one state query for the tracked windows")
+        XCTAssertEqual(report.latenciesNs[0], 350 * ms + WsEventReplay.Config().cgsDurationNs)
+    }
+
+    // MARK: - C. Storms
+
+    /// 200 tracked windows each resize 3 times, 50ms apart, right after a Space change
+    private func resizeStormDuringSpaceTransition() -> [WsTraceEvent] {
+        let wids = (1...200).map { CGWindowID($0) }
+        var trace: [WsTraceEvent] = [.snapshot(0, wids.map { raw($0) }), .notification(0, .activeSpaceChanged, wid: 0)]
+        for k in 0..<3 {
+            for wid in wids { trace.append(.notification(1 * ms + UInt64(k) * 50 * ms, .windowResized, wid: wid)) }
+        }
+        return trace
+    }
+
+    func testResizeStormDuringSpaceTransition() {
+        let report = WsEventReplay.run(resizeStormDuringSpaceTransition())
+        XCTAssertEqual(report.notifications, 601)
+        XCTAssertEqual(report.coalescible, 601)
+        XCTAssertEqual(report.coalesced, 200, "every window's third resize joins its pending tail")
+        XCTAssertEqual(report.lanes[.cgsCall]?.submitted, 402, "200 leading edges + 200 tails + the Space sync and its state query")
+        XCTAssertEqual(report.lanes[.cgsCall]?.peakDepth, 196, "4 workers, 200 simultaneous queries")
+        XCTAssertNil(report.lanes[.scan], "resizes of tracked windows never touch AX")
+        XCTAssertEqual(report.latencyPercentileNs(100), 250 * ms + WsEventReplay.Config().cgsDurationNs, "the Space debounce is the slowest path")
+        XCTAssertLessThan(report.latencyPercentileNs(50), 200 * ms)
+    }
+
+    func testReplayIsDeterministic() {
+        let trace = resizeStormDuringSpaceTransition()
+        XCTAssertEqual(WsEventReplay.run(trace), WsEventReplay.run(trace))
+    }
+
+    // MARK: - D. Retries and quarantine
+
+    func testTimeoutsRetryWithBackoffAndQuarantineThePid() {
+        let report = WsEventReplay.run([
+            .snapshot(0, [raw(1)]),
+            .notification(0, .windowOrderedOut, wid: 1),
+            .axCompletion(0, key: "wid-1-liveness", pid: 42, durationNs: 100 * ms, timedOut: true),
+            .axCompletion(0, key: "wid-1-liveness", pid: 42, durationNs: 100 * ms, timedOut: true),
+        ])
+        XCTAssertEqual(report.retries, 2)
+        XCTAssertEqual(report.quarantinedPids, [42])
+        XCTAssertEqual(report.giveUps, 0)
+        XCTAssertEqual(report.lanes[.retry]?.submitted, 2)
+        // 100ms + 200ms backoff + 100ms + 1s backoff + a successful attempt
+        XCTAssertEqual(report.latenciesNs[0], 1_400 * ms + WsEventReplay.Config().defaultAxDurationNs)
+    }
+
+    func testGivesUpAfterTheRetryWindow() {
+        let report = WsEventReplay.run([
+            .snapshot(0, [raw(1)]),
+            .notification(0, .windowOrderedOut, wid: 1),
+            .axCompletion(0, key: "wid-1-liveness", pid: 42, durationNs: 30_000 * ms, timedOut: true),
+            .axCompletion(0, key: "wid-1-liveness", pid: 42, durationNs: 30_000 * ms, timedOut: true),
+        ])
+        XCTAssertEqual(report.retries, 1)
+        XCTAssertEqual(report.giveUps, 1)
+        XCTAssertEqual(report.axAttempts, 3, "two liveness attempts + the generic read")
+    }
+
+    func testNewerCallCancelsAPendingRetry() {
+        let report = WsEventReplay.run([
+            .snapshot(0, [raw(1)]),
+            .notification(0, .windowOrderedOut, wid: 1),
+            .axCompletion(0, key: "wid-1-liveness", pid: 42, durationNs: 100 * ms, timedOut: true),
+            .notification(150 * ms, .windowOrderedOut, wid: 1),
+        ])
+        XCTAssertEqual(report.retries, 1)
+        XCTAssertEqual(report.cancelledRetries, 1)
+        XCTAssertEqual(report.giveUps, 0)
+        // the first orderedOut waited on the cancelled retry, so it finishes with the call that replaced it
+        XCTAssertEqual(report.latenciesNs[0], 300 * ms + WsEventReplay.Config().defaultAxDurationNs)
+    }
+}
@@ -2,7 +2,7 @@ import Cocoa
 
 /// One window's raw fields, read from the WindowServer in a single `SLSWindowQueryWindows` batch
 /// (see `WindowServerQuery`). Plain data so `WsWindowState` decoding stays pure and testable.
-struct WsRawWindow: Equatable {
+struct WsRawWindow: Equatable, Codable {
     let wid: CGWindowID
     let pid: pid_t
     let attributes: UInt64